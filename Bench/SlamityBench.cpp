@@ -0,0 +1,85 @@
+#include "SlamityDSP.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//==============================================================================
+// SlamityBench: times the DSP core per oversampling factor.
+//
+// Renders ten seconds of stereo noise-modulated drums at 48 kHz in 512-sample
+// blocks and prints the cost per host sample and as a share of real time.
+//==============================================================================
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = (int)(10.0 * sampleRate) / blockSize;
+
+    void fillInput(std::vector<float>& left, std::vector<float>& right)
+    {
+        uint32_t noise = 0x12345678;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+            const double env = std::exp(-(double)(i % 12000) / 2400.0);
+            const double n = (double)noise / 4294967296.0 - 0.5;
+            left[i]  = (float)(env * (0.6 * std::sin(0.0131 * (double)i) + 0.4 * n));
+            right[i] = (float)(env * (0.6 * std::sin(0.0127 * (double)i) - 0.4 * n));
+        }
+    }
+
+    double timeRender(int factor, SlamityDSP::MathMode mode,
+                      const std::vector<float>& inL, const std::vector<float>& inR)
+    {
+        SlamityDSP::Parameters params;
+        params.mackInTrim = 0.2f;
+        params.drumDrive  = 0.6f;
+        params.drumDryWet = 0.8f;
+
+        SlamityDSP dsp;
+        dsp.setParameters(params);
+        dsp.prepare(sampleRate, blockSize);
+        dsp.setOversamplingFactor(factor);
+        dsp.setMathMode(mode);
+
+        std::vector<float> left(inL), right(inR);
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            float* channels[] = { left.data() + b * blockSize, right.data() + b * blockSize };
+            dsp.process(channels, blockSize);
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+}
+
+int main()
+{
+    std::vector<float> inL((size_t)(numBlocks * blockSize)), inR(inL.size());
+    fillInput(inL, inR);
+
+    const double audioSeconds = (double)inL.size() / sampleRate;
+    std::printf("%-8s %-8s %12s %10s\n", "factor", "maths", "ns/sample", "% realtime");
+
+    for (auto mode : { SlamityDSP::MathMode::precise, SlamityDSP::MathMode::fast })
+    {
+        for (int factor : { 1, 2, 4 })
+        {
+            timeRender(factor, mode, inL, inR);     // warm up
+            const double seconds = timeRender(factor, mode, inL, inR);
+
+            std::printf("%-8d %-8s %12.1f %10.3f\n", factor,
+                        mode == SlamityDSP::MathMode::fast ? "fast" : "precise",
+                        seconds * 1.0e9 / (double)inL.size(), 100.0 * seconds / audioSeconds);
+        }
+    }
+
+    return 0;
+}
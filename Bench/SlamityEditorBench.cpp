@@ -0,0 +1,155 @@
+#include "PluginEditor.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+// SlamityEditorBench: times painting the editor without a display.
+//
+// Opens an editor on a processor and renders it into an offscreen image at
+// several window sizes and display scales. Every frame first publishes
+// synthetic meter levels and runs them through the editor's meter update,
+// and turns every knob to a new position, as a busy session would. Reports
+// the full editor, each VU meter and each control on its own: the first
+// frame (which builds the cached images for a new size or scale), the mean
+// over the rest of the first pass through the knob steps (each knob step
+// renders its filmstrip frame), and the mean over the second pass (every
+// frame cached, so only blits). Each run starts from a freshly decoded
+// image store, so no run inherits another's frames.
+//==============================================================================
+
+namespace
+{
+    constexpr int framesPerPass = RotaryFilmstrip::numSteps + 1;      // every knob step once
+    constexpr int numFrames = 2 * framesPerPass;
+    constexpr double sampleRate = 48000.0;
+    constexpr int framesPerTick = 3;                                    // ~30 Hz timer, 10 ms frames
+
+    const float sizes[]  = { 0.75f, 1.0f, 1.5f };           // times the background image size
+    const float scales[] = { 1.0f, 1.25f, 1.5f, 2.0f };     // display scale, fractional ones included
+
+    // Editor children in the order it adds them
+    const char* const childNames[] = {
+        "In Trim", "Out Pad", "Mack Dry/Wet", "Drive", "Drum Output", "Drum Dry/Wet",
+        "Main Output", "Main Dry/Wet", "Chain Order",
+        "VU In Trim", "VU Out Pad", "VU Drive", "VU Drum Output", "VU Main Out"
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Timing
+    {
+        const char* name;
+        juce::Component* component;
+        double firstMs = 0.0;
+        double coldMs = 0.0;        // rest of the first pass
+        double cachedMs = 0.0;      // second pass
+    };
+
+    // Meter levels that sweep each point across the scale at its own rate
+    void publishMeterFrames(SlamityProcessor& processor, int frame)
+    {
+        for (int i = 0; i < framesPerTick; ++i)
+        {
+            SlamityDSP::MeterFrame meter;
+            const double t = (double)(frame * framesPerTick + i) * SlamityDSP::meterPeriodSeconds;
+            for (int p = 0; p < SlamityDSP::numMeterPoints; ++p)
+            {
+                const double level = 0.5 + 0.5 * std::sin(t * (1.3 + 0.4 * p));
+                meter.rms[p]  = (float)(0.02 + 0.4 * level);
+                meter.peak[p] = meter.rms[p] * 1.4f;
+            }
+            meter.numSamples = (int)(sampleRate * SlamityDSP::meterPeriodSeconds);
+            processor.meterFrames.push(meter);
+        }
+    }
+
+    double paintMs(juce::Graphics& g, juce::Component& component, juce::Point<int> origin)
+    {
+        juce::Graphics::ScopedSaveState state(g);
+        g.setOrigin(origin);
+
+        const auto start = Clock::now();
+        component.paintEntireComponent(g, true);
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void run(SlamityProcessor& processor, juce::Rectangle<int> nativeBounds, float size, float scale)
+    {
+        SlamityEditor editor(processor);
+
+        // The editor holds the only reference, so this is a new store
+        const auto assets = SlamityAssets::getInstance();
+        while (! assets->isReady())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        editor.setSize(juce::roundToInt((float)nativeBounds.getWidth() * size),
+                       juce::roundToInt((float)nativeBounds.getHeight() * size));
+
+        // Children before the editor, so each one's first frame includes
+        // building its own cached images
+        std::vector<Timing> timings;
+        const bool named = editor.getNumChildComponents() == (int)std::size(childNames);
+        for (int i = 0; i < editor.getNumChildComponents(); ++i)
+            timings.push_back({ named ? childNames[i] : "Child", editor.getChildComponent(i) });
+        timings.push_back({ "Editor", &editor });
+
+        juce::Image image(juce::Image::ARGB,
+                          juce::roundToInt((float)editor.getWidth() * scale),
+                          juce::roundToInt((float)editor.getHeight() * scale), true);
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            publishMeterFrames(processor, frame);
+            editor.updateMeters();
+
+            const double knobPos = (double)(frame % framesPerPass) / RotaryFilmstrip::numSteps;
+            for (auto& t : timings)
+                if (auto* slider = dynamic_cast<juce::Slider*>(t.component))
+                    slider->setValue(slider->proportionOfLengthToValue(knobPos), juce::dontSendNotification);
+
+            for (auto& t : timings)
+            {
+                const auto origin = t.component == &editor ? juce::Point<int>() : t.component->getPosition();
+                const double ms = paintMs(g, *t.component, origin);
+                if (frame == 0)
+                    t.firstMs = ms;
+                else if (frame < framesPerPass)
+                    t.coldMs += ms;
+                else
+                    t.cachedMs += ms;
+            }
+        }
+
+        for (const auto& t : timings)
+            std::printf("%4dx%-4d %5.2f  %-16s %10.3f %12.1f %12.1f\n", editor.getWidth(), editor.getHeight(),
+                        scale, t.name, t.firstMs, t.coldMs * 1000.0 / (framesPerPass - 1),
+                        t.cachedMs * 1000.0 / framesPerPass);
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    SlamityProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, 512);
+    processor.prepareToPlay(sampleRate, 512);
+
+    // Read from the PNG header; the store is dropped again straight away
+    const auto nativeBounds = SlamityAssets::getInstance()->getNativeBounds(SlamityAssets::background);
+
+    std::printf("%d frames per pass, 2 passes per run\n", framesPerPass);
+    std::printf("%-9s %5s  %-16s %10s %12s %12s\n", "size", "scale", "component", "first ms", "pass 1 us", "pass 2 us");
+
+    for (float size : sizes)
+        for (float scale : scales)
+            run(processor, nativeBounds, size, scale);
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "SlamityDSP.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//==============================================================================
+// SlamityKernelBench: times the DSP kernel stage by stage, as JSON.
+//
+// For both chain orders, several sample rates and block sizes from 1 to
+// 4096, renders one second of stereo noise-modulated drums with every stage
+// and mix engaged and metering on. The total is the best of three untimed
+// runs; the stage breakdown comes from one more run with the stage timers
+// on, which cost a little on top (most visibly at small block sizes), so
+// "other" (processing around the kernel) is the total less the stages.
+// All figures are nanoseconds per host sample (one stereo frame).
+//
+// Writes the JSON to stdout, or to the file given as the only argument.
+//==============================================================================
+
+namespace
+{
+    constexpr int numRuns = 3;
+
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const int blockSizes[] = { 1, 4, 16, 64, 256, 1024, 4096 };
+
+    const char* const stageNames[SlamityDSP::numStages] = {
+        "input", "resampling",
+        "mackHighPass", "mackBiquad", "mackShaper",
+        "drumCrossover", "drumLowShaper", "drumMidShaper", "drumHighShaper", "drumRecombine",
+        "stageGain", "mainMix", "metering", "dither"
+    };
+
+    void fillInput(std::vector<float>& left, std::vector<float>& right)
+    {
+        uint32_t noise = 0x12345678;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+            const double env = std::exp(-(double)(i % 12000) / 2400.0);
+            const double n = (double)noise / 4294967296.0 - 0.5;
+            left[i]  = (float)(env * (0.6 * std::sin(0.0131 * (double)i) + 0.4 * n));
+            right[i] = (float)(env * (0.6 * std::sin(0.0127 * (double)i) - 0.4 * n));
+        }
+    }
+
+    struct Result
+    {
+        bool mackFirst = true;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        double total = 0.0;                             // ns per host sample
+        double stages[SlamityDSP::numStages] = {};      // ns per host sample
+    };
+
+    // Seconds to render the input through dsp in blockSize blocks
+    double render(SlamityDSP& dsp, int blockSize, const std::vector<float>& inL, const std::vector<float>& inR,
+                  std::vector<float>& left, std::vector<float>& right, SlamityDSP::MeterRing& meters)
+    {
+        left = inL;
+        right = inR;
+        const int numSamples = (int)left.size();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            float* channels[] = { left.data() + pos, right.data() + pos };
+            dsp.process(channels, std::min(blockSize, numSamples - pos));
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        SlamityDSP::MeterFrame frame;
+        while (meters.pop(frame)) {}
+        return elapsed.count();
+    }
+
+    Result measure(bool mackFirst, double sampleRate, int blockSize)
+    {
+        std::vector<float> inL((size_t)sampleRate), inR(inL.size()), left, right;
+        fillInput(inL, inR);
+
+        SlamityDSP::Parameters params;
+        params.mackInTrim = 0.2f;
+        params.mackDryWet = 0.9f;
+        params.drumDrive  = 0.6f;
+        params.drumDryWet = 0.8f;
+        params.chainOrder = mackFirst ? 0.0f : 1.0f;
+        params.mainDryWet = 0.9f;
+
+        // The ring only holds 64 frames; once it is full the rest are
+        // dropped, which costs the same as publishing them
+        SlamityDSP::MeterRing meters;
+        SlamityDSP dsp;
+        dsp.setParameters(params);
+        dsp.prepare(sampleRate, blockSize);
+        dsp.setMeterOutput(&meters);
+
+        render(dsp, blockSize, inL, inR, left, right, meters);     // warm up
+
+        Result result { mackFirst, sampleRate, blockSize };
+        const double nsPerSample = 1.0e9 / (double)inL.size();
+
+        double best = 1.0e30;
+        for (int run = 0; run < numRuns; ++run)
+            best = std::min(best, render(dsp, blockSize, inL, inR, left, right, meters));
+        result.total = best * nsPerSample;
+
+        dsp.resetStageTimes();
+        dsp.setStageProfiling(true);
+        render(dsp, blockSize, inL, inR, left, right, meters);
+        dsp.setStageProfiling(false);
+
+        for (int s = 0; s < SlamityDSP::numStages; ++s)
+            result.stages[s] = dsp.getStageTimes().nanoseconds[s] / (double)inL.size();
+        return result;
+    }
+
+    void writeJson(std::FILE* out, const std::vector<Result>& results)
+    {
+        std::fprintf(out, "{\n  \"benchmark\": \"SlamityKernelBench\",\n");
+        std::fprintf(out, "  \"unit\": \"ns per host sample\",\n  \"channels\": 2,\n  \"results\": [\n");
+
+        for (size_t r = 0; r < results.size(); ++r)
+        {
+            const Result& result = results[r];
+            std::fprintf(out, "    {\n      \"chainOrder\": \"%s\",\n", result.mackFirst ? "mackity-drumslam" : "drumslam-mackity");
+            std::fprintf(out, "      \"sampleRate\": %.0f,\n      \"blockSize\": %d,\n", result.sampleRate, result.blockSize);
+            std::fprintf(out, "      \"total\": %.3f,\n      \"stages\": {\n", result.total);
+
+            double staged = 0.0;
+            for (int s = 0; s < SlamityDSP::numStages; ++s)
+            {
+                std::fprintf(out, "        \"%s\": %.3f,\n", stageNames[s], result.stages[s]);
+                staged += result.stages[s];
+            }
+            std::fprintf(out, "        \"other\": %.3f\n      }\n    }%s\n",
+                         std::max(0.0, result.total - staged), r + 1 < results.size() ? "," : "");
+        }
+
+        std::fprintf(out, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<Result> results;
+    for (bool mackFirst : { true, false })
+        for (double sampleRate : sampleRates)
+            for (int blockSize : blockSizes)
+                results.push_back(measure(mackFirst, sampleRate, blockSize));
+
+    std::FILE* out = argc > 1 ? std::fopen(argv[1], "w") : stdout;
+    if (out == nullptr)
+    {
+        std::fprintf(stderr, "can't write %s\n", argv[1]);
+        return 1;
+    }
+
+    writeJson(out, results);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "PluginProcessor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// SlamitySessionBench: times loading a session of 500 Slamity instances.
+//
+// Creates the instances, then restores the same state into each one, once
+// from the binary format and once from the XML format that older versions
+// saved. Every parameter in the state is off its default, so each restore
+// moves all of them. Runs without a host, so host notification is free.
+//==============================================================================
+
+namespace
+{
+    constexpr int numInstances = 500;
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void loadSession(const char* format, const juce::MemoryBlock& state)
+    {
+        std::vector<std::unique_ptr<SlamityProcessor>> instances;
+        instances.reserve(numInstances);
+
+        auto start = Clock::now();
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<SlamityProcessor>());
+        const double createMs = millisecondsSince(start);
+
+        start = Clock::now();
+        for (auto& instance : instances)
+            instance->setStateInformation(state.getData(), (int)state.getSize());
+        const double restoreMs = millisecondsSince(start);
+
+        std::printf("%-8s %8d %12.2f %12.2f %14.2f\n", format, (int)state.getSize(),
+                    createMs, restoreMs, restoreMs * 1000.0 / numInstances);
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::MemoryBlock binaryState, xmlState;
+    {
+        SlamityProcessor source;
+        for (auto* param : source.getParameters())
+            param->setValueNotifyingHost(0.5f);
+
+        source.getStateInformation(binaryState);
+
+        const auto xml = source.apvts.copyState().createXml();
+        juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+    }
+
+    std::printf("%d instances\n", numInstances);
+    std::printf("%-8s %8s %12s %12s %14s\n", "format", "bytes", "create ms", "restore ms", "us/instance");
+
+    loadSession("binary", binaryState);
+    loadSession("xml", xmlState);
+
+    return 0;
+}
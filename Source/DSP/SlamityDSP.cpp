@@ -0,0 +1,1093 @@
+#include "SlamityDSP.h"
+#include "SlamityFastMath.h"
+#include "SlamityOnePole.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//==============================================================================
+// SlamityDSP: JUCE-free Mackity + DrumSlam processing core
+// DSP derived from Airwindows by Chris Johnson (MIT License)
+//==============================================================================
+
+namespace
+{
+    constexpr double pi = 3.141592653589793238;
+
+    // Inputs below this are treated as digital silence (the Airwindows
+    // denormal guard replaces them with noise)
+    constexpr float silenceThreshold = 1.18e-23f;
+
+    // Once the input is silent and every filter state is below this (under
+    // the 24-bit LSB), the processor sleeps and outputs exact zeros
+    constexpr double sleepThreshold = 1.0e-8;
+
+    template <typename Array>
+    void zero(Array& a) { std::fill(std::begin(a), std::end(a), 0.0); }
+}
+
+// Times the rest of the enclosing scope as one kernel stage, in profiling
+// builds only (see SlamityDSP::Stage)
+#if SLAMITY_STAGE_PROFILING
+ #define SLAMITY_TIME_STAGE(stage) const StageTimer stageTimer { *this, stage }
+#else
+ #define SLAMITY_TIME_STAGE(stage)
+#endif
+
+//==============================================================================
+void SlamityDSP::prepare(double newSampleRate, int newMaxBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = newMaxBlockSize > 0 ? newMaxBlockSize : 1;
+    numChannels = std::clamp(newNumChannels, 1, maxChannels);
+    state.sampleRate = sampleRate;
+    state.numChannels = numChannels;
+    rampBuffer.assign((size_t)(numGains * maxBlockSize), 0.0);
+
+    // Enough for one chunk of the widest vector type at the highest rate
+    scratchFrames = std::min(maxBlockSize, maxScratchFrames);
+    scratch.assign((size_t)(numScratchBuffers * scratchFrames * SlamityOversampler::maxFactor), ScratchFrame {});
+    meterChunks.assign((size_t)((maxBlockSize + scratchFrames - 1) / scratchFrames), MeterTotals {});
+    meterPeriodSamples = std::max(1, (int)std::lround(meterPeriodSeconds * sampleRate));
+
+    rampSamples = (int)std::lround(smoothingSeconds * sampleRate);
+    fadeInSamples = (int)std::lround(0.005 * sampleRate);
+
+    updateRateCoefficients();
+    updateParameterTargets(0);
+    parametersChanged = false;
+
+    reset();
+}
+
+void SlamityDSP::reset()
+{
+    clearFilterState();
+    state.drumSlam.fpFlip = true;
+    state.sleeping = false;
+    state.mackBypassed = state.drumBypassed = false;
+
+    // Land any gain ramps in progress
+    for (auto& g : state.gains) g.snapTo(g.getTargetValue());
+
+    // Initialize TPDF dither state
+    for (auto& f : state.fpd)
+    {
+        f = 1;
+        while (f < 16386) f = (uint32_t)rand() * (uint32_t)UINT32_MAX;
+    }
+
+    meterPeriod = {};
+}
+
+void SlamityDSP::clearFilterState()
+{
+    clearMackityState();
+    clearDrumSlamState();
+    clearLatencyState();
+}
+
+void SlamityDSP::clearLatencyState()
+{
+    for (auto& o : state.latency.oversamplers) o.reset();
+    for (auto& s : state.latency.dryDelay) zero(s);
+    state.latency.dryDelayPos = 0;
+}
+
+void SlamityDSP::clearMackityState()
+{
+    state.mackity = {};
+}
+
+void SlamityDSP::clearDrumSlamState()
+{
+    // Which filter set is next is not history, so it carries over
+    const bool fpFlip = state.drumSlam.fpFlip;
+    state.drumSlam = {};
+    state.drumSlam.fpFlip = fpFlip;
+}
+
+bool SlamityDSP::setState(const State& snapshot)
+{
+    if (snapshot.sampleRate != sampleRate || snapshot.numChannels != numChannels
+        || snapshot.latency.oversamplers[0].getFactor() != getOversamplingFactor())
+        return false;
+
+    state = snapshot;
+    return true;
+}
+
+double SlamityDSP::getFilterStatePeak() const
+{
+    double peak = 0.0;
+    auto scan = [&peak](const double (&lanes)[maxChannels]) {
+        for (double v : lanes) peak = std::max(peak, std::fabs(v));
+    };
+
+    scan(state.mackity.iirSampleA);
+    scan(state.mackity.iirSampleB);
+    for (auto& s : state.mackity.biquadA) scan(s);
+    for (auto& s : state.mackity.biquadB) scan(s);
+
+    scan(state.drumSlam.iirSampleA);
+    scan(state.drumSlam.iirSampleB);
+    scan(state.drumSlam.iirSampleC);
+    scan(state.drumSlam.iirSampleD);
+    scan(state.drumSlam.iirSampleE);
+    scan(state.drumSlam.iirSampleF);
+    scan(state.drumSlam.iirSampleG);
+    scan(state.drumSlam.iirSampleH);
+    scan(state.drumSlam.lastSample);
+
+    for (auto& s : state.latency.dryDelay) scan(s);
+    for (auto& o : state.latency.oversamplers) peak = std::max(peak, o.getPeak());
+    return peak;
+}
+
+double SlamityDSP::getTailLengthSeconds() const
+{
+    // The slowest pole is the Mackity DC blocker (IIR B): time for a
+    // full-scale state to decay to the sleep threshold, plus the latency
+    const double stageRate = sampleRate * getOversamplingFactor();
+    const double amount = 0.000287496 / (stageRate / 44100.0);
+    return std::log(sleepThreshold) / std::log1p(-amount) / stageRate
+         + getLatencySamples() / sampleRate;
+}
+
+//==============================================================================
+void SlamityDSP::setParameters(const Parameters& newParams)
+{
+    params = newParams;
+    parametersChanged = true;
+}
+
+void SlamityDSP::setParameter(ParamId id, float value)
+{
+    if (params[id] == value) return;
+    params[id] = value;
+    parametersChanged = true;
+}
+
+void SlamityDSP::setMeterOutput(MeterRing* ring)
+{
+    if (ring != meterOutput) meterPeriod = {};
+    meterOutput = ring;
+}
+
+void SlamityDSP::addMeterTotals(const MeterTotals& totals)
+{
+    for (int m = 0; m < numMeterPoints; ++m)
+    {
+        meterPeriod.sumSquares[m] += totals.sumSquares[m];
+        meterPeriod.peak[m] = std::max(meterPeriod.peak[m], totals.peak[m]);
+    }
+    meterPeriod.numSamples += totals.numSamples;
+
+    if (meterPeriod.numSamples < meterPeriodSamples) return;
+
+    MeterFrame frame;
+    const double invN = 1.0 / ((double)meterPeriod.numSamples * (double)numChannels);
+    for (int m = 0; m < numMeterPoints; ++m)
+    {
+        frame.rms[m] = (float)std::sqrt(meterPeriod.sumSquares[m] * invN);
+        frame.peak[m] = meterPeriod.peak[m];
+        if (frame.peak[m] >= 1.0f) frame.clipped |= 1u << m;
+    }
+    frame.numSamples = meterPeriod.numSamples;
+
+    meterOutput->push(frame);
+    meterPeriod = {};
+}
+
+void SlamityDSP::setOversamplingFactor(int factor)
+{
+    for (auto& o : state.latency.oversamplers) o.setFactor(factor);
+    updateRateCoefficients();
+    clearFilterState();
+}
+
+void SlamityDSP::setPrecision(Precision newPrecision)
+{
+    if (precision == newPrecision) return;
+    precision = newPrecision;
+    clearFilterState();
+}
+
+void SlamityDSP::setSmoothingTime(double seconds)
+{
+    smoothingSeconds = seconds;
+    rampSamples = (int)std::lround(smoothingSeconds * sampleRate);
+}
+
+//==============================================================================
+void SlamityDSP::updateRateCoefficients()
+{
+    auto& c = coeffs;
+
+    // The stages run at the oversampled rate
+    const double sr = sampleRate * getOversamplingFactor();
+    double overallscale = 1.0;
+    overallscale /= 44100.0;
+    overallscale *= sr;
+
+    // =====================================================================
+    // MACKITY: filter coefficients
+    // =====================================================================
+    c.mackIirAmountA = 0.001860867 / overallscale;
+    c.mackIirAmountB = 0.000287496 / overallscale;
+
+    double* bqA = c.mackBiquadA;
+    double* bqB = c.mackBiquadB;
+    bqB[0] = bqA[0] = 19160.0 / sr;
+    bqA[1] = 0.431684981684982;
+    bqB[1] = 1.1582298;
+
+    double K = tan(pi * bqA[0]);
+    double norm = 1.0 / (1.0 + K / bqA[1] + K * K);
+    bqA[2] = K * K * norm;
+    bqA[3] = 2.0 * bqA[2];
+    bqA[4] = bqA[2];
+    bqA[5] = 2.0 * (K * K - 1.0) * norm;
+    bqA[6] = (1.0 - K / bqA[1] + K * K) * norm;
+
+    K = tan(pi * bqB[0]);
+    norm = 1.0 / (1.0 + K / bqB[1] + K * K);
+    bqB[2] = K * K * norm;
+    bqB[3] = 2.0 * bqB[2];
+    bqB[4] = bqB[2];
+    bqB[5] = 2.0 * (K * K - 1.0) * norm;
+    bqB[6] = (1.0 - K / bqB[1] + K * K) * norm;
+
+    // =====================================================================
+    // DRUMSLAM: crossover coefficients
+    // =====================================================================
+    c.drumIirAmountL = 0.0819 / overallscale;
+    c.drumIirAmountH = 0.377933067 / overallscale;
+}
+
+void SlamityDSP::updateParameterTargets(int rampLength)
+{
+    // MACKITY
+    double mackInTrim = params.mackInTrim * 10.0;
+    mackInTrim *= mackInTrim;
+    state.gains[mackTrimGain].setTarget(mackInTrim, rampLength);
+    state.gains[mackPadGain].setTarget(params.mackOutPad, rampLength);
+    state.gains[mackWetGain].setTarget(params.mackDryWet, rampLength);
+
+    // DRUMSLAM
+    state.gains[drumDriveGain].setTarget((params.drumDrive * 3.0) + 1.0, rampLength);
+    state.gains[drumOutGain].setTarget(params.drumOutput, rampLength);
+    state.gains[drumWetGain].setTarget(params.drumDryWet, rampLength);
+
+    // GLOBAL
+    state.gains[mainOutGain].setTarget(params.mainOutput, rampLength);
+    state.gains[mainWetGain].setTarget(params.mainDryWet, rampLength);
+    mackFirst = params.chainOrder < 0.5f;
+}
+
+//==============================================================================
+void SlamityDSP::process(float* const* channels, int numSamples)
+{
+    processEvents(channels, numSamples, nullptr, 0);
+}
+
+void SlamityDSP::process(float* const* channels, int numSamples,
+                         const ParameterEvent* events, int numEvents)
+{
+    processEvents(channels, numSamples, events, numEvents);
+}
+
+void SlamityDSP::process(double* const* channels, int numSamples)
+{
+    processEvents(channels, numSamples, nullptr, 0);
+}
+
+void SlamityDSP::process(double* const* channels, int numSamples,
+                         const ParameterEvent* events, int numEvents)
+{
+    processEvents(channels, numSamples, events, numEvents);
+}
+
+template <typename Sample>
+void SlamityDSP::processEvents(Sample* const* channels, int numSamples,
+                               const ParameterEvent* events, int numEvents)
+{
+    if (numSamples <= 0) return;
+
+    // Split at every event offset, and at maxBlockSize so the ramp buffers fit
+    int pos = 0, nextEvent = 0;
+    while (pos < numSamples)
+    {
+        while (nextEvent < numEvents && events[nextEvent].sampleOffset <= pos)
+        {
+            setParameter(events[nextEvent].id, events[nextEvent].value);
+            ++nextEvent;
+        }
+
+        int end = std::min(numSamples, pos + maxBlockSize);
+        if (nextEvent < numEvents)
+            end = std::min(end, events[nextEvent].sampleOffset);
+
+        if (parametersChanged)
+        {
+            updateParameterTargets(rampSamples);
+            parametersChanged = false;
+        }
+
+        Sample* segment[maxChannels];
+        for (int ch = 0; ch < numChannels; ++ch)
+            segment[ch] = channels[ch] + pos;
+
+        processSegment(segment, end - pos);
+        pos = end;
+    }
+
+    // Events past the end of the block still take effect from the next one
+    for (; nextEvent < numEvents; ++nextEvent)
+        setParameter(events[nextEvent].id, events[nextEvent].value);
+}
+
+template <typename Sample>
+void SlamityDSP::processSegment(Sample* const* channels, int numSamples)
+{
+    bool inputSilent = true;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const Sample* x = channels[ch];
+        bool loud = false;
+        for (int i = 0; i < numSamples; ++i)
+            loud |= std::fabs(x[i]) >= silenceThreshold;
+        inputSilent &= ! loud;
+    }
+
+    if (state.sleeping)
+    {
+        if (inputSilent)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::fill(channels[ch], channels[ch] + numSamples, Sample(0));
+
+            for (auto& g : state.gains) g.snapTo(g.getTargetValue());
+
+            // Keep the meters falling while asleep
+            if (meterOutput != nullptr)
+            {
+                MeterTotals silence;
+                silence.numSamples = numSamples;
+                addMeterTotals(silence);
+            }
+            return;
+        }
+
+        state.sleeping = false;
+    }
+
+    // Silent input is fed through as exact zeros instead of denormal-guard
+    // noise, so the filter tails can actually decay
+    guardNoiseScale = inputSilent ? 0.0 : 1.18e-17;
+
+    bool ramping = false;
+    for (auto& g : state.gains) ramping |= g.isRamping();
+
+    // Skip stages that are fully dry. Their state is dropped on the way out
+    // so a stale tail can't click back in (or keep the processor awake), and
+    // on the way back in the stage's wet gain fades up from zero while its
+    // filters settle, even with smoothing turned off.
+    const bool mainIdle = state.gains[mainWetGain].getCurrentValue() == 0.0;
+    const bool mackIdle = ! ramping && (mainIdle || state.gains[mackWetGain].getCurrentValue() == 0.0);
+    const bool drumIdle = ! ramping && (mainIdle || state.gains[drumWetGain].getCurrentValue() == 0.0);
+
+    auto updateBypass = [this](bool& bypassed, bool idle, Gain wetGain, void (SlamityDSP::*clearState)()) {
+        if (idle && ! bypassed)
+        {
+            (this->*clearState)();
+        }
+        else if (bypassed && ! idle && ! state.gains[wetGain].isRamping())
+        {
+            const double wet = state.gains[wetGain].getTargetValue();
+            state.gains[wetGain].snapTo(0.0);
+            state.gains[wetGain].setTarget(wet, fadeInSamples);
+        }
+        bypassed = idle;
+    };
+
+    updateBypass(state.mackBypassed, mackIdle, mackWetGain, &SlamityDSP::clearMackityState);
+    updateBypass(state.drumBypassed, drumIdle, drumWetGain, &SlamityDSP::clearDrumSlamState);
+
+    for (auto& g : state.gains) ramping |= g.isRamping();
+
+    const double* gainRamps[numGains] = {};
+    unsigned flags = 0;
+
+    if (ramping || getOversamplingFactor() > 1)
+    {
+        // Render every gain for this segment, ramping or not, so the kernel
+        // reads them all the same way
+        for (int g = 0; g < numGains; ++g)
+        {
+            double* dest = rampBuffer.data() + (size_t)(g * maxBlockSize);
+            state.gains[g].fill(dest, numSamples);
+            gainRamps[g] = dest;
+        }
+
+        flags = rampingFlag | mackMixFlag | drumMixFlag | mainMixFlag;
+        if (getOversamplingFactor() > 1) flags |= oversampledFlag;
+    }
+    else
+    {
+        if (state.gains[mackWetGain].getCurrentValue() != 1.0) flags |= mackMixFlag;
+        if (state.gains[drumWetGain].getCurrentValue() != 1.0) flags |= drumMixFlag;
+        if (state.gains[mainWetGain].getCurrentValue() != 1.0) flags |= mainMixFlag;
+    }
+
+    if (mackFirst) flags |= mackFirstFlag;
+    if (meterOutput != nullptr) flags |= meteringFlag;
+    if (state.mackBypassed) flags |= mackBypassFlag;
+    if (state.drumBypassed) flags |= drumBypassFlag;
+
+    // Stereo and mono stay on two-lane double vectors, the reference path;
+    // wider layouts use four-lane vectors where the build has them
+    KernelFn<Sample> kernel = getKernelForMathMode<Vec2d, Sample>(flags);
+
+   #if SLAMITY_SIMD_AVX
+    if (numChannels > 2)
+        kernel = getKernelForMathMode<Vec4d, Sample>(flags);
+   #endif
+
+    if constexpr (std::is_same_v<Sample, float>)
+        if (precision == Precision::floatKernel)
+            kernel = getKernelForMathMode<Vec4f, float>(flags);
+
+    (this->*kernel)(channels, numSamples, gainRamps);
+
+    if (inputSilent && getFilterStatePeak() < sleepThreshold)
+    {
+        clearFilterState();
+        state.sleeping = true;
+    }
+}
+
+template <typename V, typename Sample>
+SlamityDSP::KernelFn<Sample> SlamityDSP::getKernelForMathMode(unsigned flags) const
+{
+    return mathMode == MathMode::fast ? getKernel<FastMath, V, Sample>(flags)
+                                      : getKernel<PreciseMath, V, Sample>(flags);
+}
+
+// Picks the kernel instantiation for a set of flags. The table covers every
+// combination, but only the canonical ones (see canonicalKernelFlags) are
+// actually compiled.
+template <typename Maths, typename V, typename Sample>
+SlamityDSP::KernelFn<Sample> SlamityDSP::getKernel(unsigned flags)
+{
+    static constexpr auto kernels = makeKernelTable<Maths, V, Sample>(std::make_integer_sequence<unsigned, numKernelFlagCombinations>{});
+    return kernels[flags];
+}
+
+template <typename Maths, typename V, typename Sample, unsigned flags>
+void SlamityDSP::processKernel(Sample* const* channels, int sampleFrames, const double* const* gainRamps)
+{
+    const Coefficients& c = coeffs;
+    MackityState& mack = state.mackity;
+    DrumSlamState& drum = state.drumSlam;
+
+    constexpr bool ramping   = (flags & rampingFlag) != 0;
+    constexpr bool mackFirstOrder = (flags & mackFirstFlag) != 0;
+    constexpr bool mackMix   = (flags & mackMixFlag) != 0;
+    constexpr bool drumMix   = (flags & drumMixFlag) != 0;
+    constexpr bool mainMix   = (flags & mainMixFlag) != 0;
+    constexpr bool metering  = (flags & meteringFlag) != 0;
+    constexpr bool mackOn    = (flags & mackBypassFlag) == 0;
+    constexpr bool drumOn    = (flags & drumBypassFlag) == 0;
+    constexpr bool oversampled = (flags & oversampledFlag) != 0;
+    constexpr bool floatKernel = std::is_same_v<V, Vec4f>;
+    constexpr bool floatOutput = std::is_same_v<Sample, float>;
+
+    // Block constants when nothing is ramping; per-sample values via gainAt()
+    // below if so.
+    // Trims and pads are always applied: multiplying by exactly 1.0 is exact
+    // and cheaper than keeping a variant for it.
+    const double mackInTrim = state.gains[mackTrimGain].getCurrentValue();
+    const double mackOutPad = state.gains[mackPadGain].getCurrentValue();
+    const double mackWet = state.gains[mackWetGain].getCurrentValue();
+    const double drumWet = state.gains[drumWetGain].getCurrentValue();
+    const double mainWet = state.gains[mainWetGain].getCurrentValue();
+
+    // =====================================================================
+    // Broadcast block constants; the filter state is loaded per channel
+    // group below.
+    // =====================================================================
+    const V zeroV = V::broadcast(0.0), oneV = V::broadcast(1.0), minusOneV = V::broadcast(-1.0);
+    const V iirThreshold = V::broadcast(1.18e-37);
+
+    const V vMackInTrim = V::broadcast(mackInTrim), vMackOutPad = V::broadcast(mackOutPad);
+    const V vMackWet = V::broadcast(mackWet), vMackDry = V::broadcast(1.0 - mackWet);
+    const V vMackA = V::broadcast(c.mackIirAmountA), vMackOneMinusA = V::broadcast(1.0 - c.mackIirAmountA);
+    const V vMackB = V::broadcast(c.mackIirAmountB), vMackOneMinusB = V::broadcast(1.0 - c.mackIirAmountB);
+    V bqA[5], bqB[5];
+    for (int k = 0; k < 5; ++k)
+    {
+        bqA[k] = V::broadcast(c.mackBiquadA[k + 2]);
+        bqB[k] = V::broadcast(c.mackBiquadB[k + 2]);
+    }
+
+    const V vDrumL = V::broadcast(c.drumIirAmountL), vDrumOneMinusL = V::broadcast(1.0 - c.drumIirAmountL);
+    const V vDrumH = V::broadcast(c.drumIirAmountH), vDrumOneMinusH = V::broadcast(1.0 - c.drumIirAmountH);
+    const V vDrumDrive = V::broadcast(state.gains[drumDriveGain].getCurrentValue());
+    const V vDrumOut = V::broadcast(state.gains[drumOutGain].getCurrentValue());
+    const V vDrumWet = V::broadcast(drumWet), vDrumDry = V::broadcast(1.0 - drumWet);
+    const V vLowShape = V::broadcast(0.448), vHighShape = V::broadcast(0.599);
+    const V vPi = V::broadcast(3.1415926), vHalfPi = V::broadcast(1.57079633);
+    const V vSkewScale = V::broadcast(1.557079633);
+
+    const V vMainOut = V::broadcast(state.gains[mainOutGain].getCurrentValue());
+    const V vMainWet = V::broadcast(mainWet), vMainDry = V::broadcast(1.0 - mainWet);
+
+    // Four-samples-per-step forms of the one-poles, for maths policies that
+    // trade bit-exactness for speed (see SlamityOnePole.h). PreciseMath runs
+    // the serial loops below instead, to stay bit-exact.
+    const SlamityOnePole<V> mackHighPassA { c.mackIirAmountA, 1.18e-37 };
+    const SlamityOnePole<V> mackHighPassB { c.mackIirAmountB, 1.18e-37 };
+    const SlamityOnePole<V> drumSplitL { c.drumIirAmountL };
+    const SlamityOnePole<V> drumSplitH { c.drumIirAmountH };
+
+    // Biquads: direct form I in the double kernel (as in the original), and
+    // transposed direct form II in the float kernel, with its two state
+    // variables kept in the x1 / x2 slots
+    auto biquad = [](V& s, const V* k, V& x1, V& x2, V& y1, V& y2) {
+        if constexpr (floatKernel)
+        {
+            V out = k[0]*s + x1;
+            x1 = k[1]*s - k[3]*out + x2;
+            x2 = k[2]*s - k[4]*out;
+            s = out;
+            (void)y1; (void)y2;
+        }
+        else
+        {
+            V out = k[0]*s + k[1]*x1 + k[2]*x2 - k[3]*y1 - k[4]*y2;
+            x2 = x1; x1 = s; s = out; y2 = y1; y1 = s;
+        }
+    };
+
+    const V denormalThreshold = V::broadcast(1.18e-23);
+    const V vGuardScale = V::broadcast(guardNoiseScale);
+
+    const int osFactor = getOversamplingFactor();
+    const int osShift = osFactor >> 1;  // stage sample -> host sample: j >> osShift
+    const int dryDelayLength = getLatencySamples();
+    const bool fpFlipAtStart = drum.fpFlip;
+    int delayPos = state.latency.dryDelayPos;
+
+    // Planar work buffers, one vector per sample (see prepare())
+    const size_t scratchStride = (size_t)(scratchFrames * SlamityOversampler::maxFactor);
+    auto scratchBuffer = [&](ScratchBufferId id) {
+        return reinterpret_cast<V*>(scratch.data() + (size_t)id * scratchStride);
+    };
+    V* const hostBuf = scratchBuffer(hostSignal);
+    V* const mainDryBuf = scratchBuffer(mainDrySignal);
+    V* const stageBuf = oversampled ? scratchBuffer(stageSignal) : hostBuf;
+    V* const stageDryBuf = scratchBuffer(stageDrySignal);
+    V* const lowBuf = scratchBuffer(lowBand);
+    V* const midBuf = scratchBuffer(midBand);
+
+    // Host frame of the current chunk that gain ramps are read from
+    int chunk = 0;
+
+    // Metering totals of the current chunk and channel group, per point
+    V meterSum[numMeterPoints], meterPeak[numMeterPoints];
+    if constexpr (metering)
+        for (auto& totals : meterChunks) totals = {};
+
+    // Metering pass over a buffer that has just reached a metering point
+    auto meter = [&](const V* x, int n, MeterPoint point) {
+        if constexpr (metering)
+        {
+            SLAMITY_TIME_STAGE(meteringStage);
+            V sum = zeroV, peak = zeroV;
+            for (int j = 0; j < n; ++j)
+            {
+                sum += x[j] * x[j];
+                peak = max(peak, abs(x[j]));
+            }
+            meterSum[point] += sum;
+            meterPeak[point] = max(meterPeak[point], peak);
+        }
+        else
+        {
+            (void)x; (void)n; (void)point;
+        }
+    };
+
+    // Gain at stage sample j: the block constant, or the ramp value of the
+    // host sample it belongs to
+    auto gainAt = [&](int g, V constant, int j) -> V {
+        if constexpr (ramping) return V::broadcast(gainRamps[g][chunk + (j >> osShift)]);
+        else { (void)g; (void)j; return constant; }
+    };
+
+    // Dry/wet crossfade at stage sample j. Ramped dry gains are 1 - wet in
+    // the vector type, exactly as the per-sample values have always been.
+    auto mixAt = [&](int g, V wet, V dry, V x, V d, int j) -> V {
+        if constexpr (ramping)
+        {
+            wet = gainAt(g, wet, j);
+            dry = oneV - wet;
+        }
+        return (x * wet) + (d * dry);
+    };
+
+    // =====================================================================
+    // Channels are processed V::size at a time. Each group runs its chunk
+    // of the segment one stage at a time: every stage loops over the whole
+    // chunk before the next starts, so the stateless stages (gains, clamps,
+    // shapers, mixes) are plain vector loops, and each recursive filter
+    // keeps only its own state in registers.
+    // =====================================================================
+    for (int base = 0; base < numChannels; base += V::size)
+    {
+        using Scalar = typename V::Scalar;
+        const int numLanes = std::min(V::size, numChannels - base);
+        Sample* lanes[V::size] = {};
+        for (int l = 0; l < numLanes; ++l)
+            lanes[l] = channels[base + l];
+
+        SlamityOversampler* groupOversamplers = state.latency.oversamplers + base / 2;
+        drum.fpFlip = fpFlipAtStart;
+        delayPos = state.latency.dryDelayPos;
+
+        V mackIirA = V::loadDoubles(mack.iirSampleA + base), mackIirB = V::loadDoubles(mack.iirSampleB + base);
+        V bqAx1 = V::loadDoubles(mack.biquadA[0] + base), bqAx2 = V::loadDoubles(mack.biquadA[1] + base);
+        V bqAy1 = V::loadDoubles(mack.biquadA[2] + base), bqAy2 = V::loadDoubles(mack.biquadA[3] + base);
+        V bqBx1 = V::loadDoubles(mack.biquadB[0] + base), bqBx2 = V::loadDoubles(mack.biquadB[1] + base);
+        V bqBy1 = V::loadDoubles(mack.biquadB[2] + base), bqBy2 = V::loadDoubles(mack.biquadB[3] + base);
+
+        V drumA = V::loadDoubles(drum.iirSampleA + base), drumB = V::loadDoubles(drum.iirSampleB + base);
+        V drumC = V::loadDoubles(drum.iirSampleC + base), drumD = V::loadDoubles(drum.iirSampleD + base);
+        V drumE = V::loadDoubles(drum.iirSampleE + base), drumF = V::loadDoubles(drum.iirSampleF + base);
+        V drumG = V::loadDoubles(drum.iirSampleG + base), drumH = V::loadDoubles(drum.iirSampleH + base);
+        V drumLast = V::loadDoubles(drum.lastSample + base);
+
+        // --- Stage building blocks over n samples ---
+        auto runHighPass = [&](V* x, int n, V& iirState, const SlamityOnePole<V>& filter, V amount, V oneMinusAmount) {
+            SLAMITY_TIME_STAGE(mackHighPassStage);
+            if constexpr (Maths::blockFilters)
+            {
+                filter.highpass(x, x, n, 1, iirState);
+                (void)amount; (void)oneMinusAmount;
+            }
+            else
+            {
+                V iir = iirState;
+                for (int j = 0; j < n; ++j)
+                {
+                    iir = select(abs(iir) < iirThreshold, zeroV, iir);
+                    iir = (iir * oneMinusAmount) + (x[j] * amount);
+                    x[j] -= iir;
+                }
+                iirState = iir;
+                (void)filter;
+            }
+        };
+
+        auto runBiquad = [&](V* x, int n, const V* k, V& sx1, V& sx2, V& sy1, V& sy2) {
+            SLAMITY_TIME_STAGE(mackBiquadStage);
+            V x1 = sx1, x2 = sx2, y1 = sy1, y2 = sy2;
+            for (int j = 0; j < n; ++j)
+                biquad(x[j], k, x1, x2, y1, y2);
+            sx1 = x1; sx2 = x2; sy1 = y1; sy2 = y2;
+        };
+
+        auto runGain = [&](V* x, int n, int g, V constant) {
+            SLAMITY_TIME_STAGE(stageGainStage);
+            for (int j = 0; j < n; ++j)
+                x[j] *= gainAt(g, constant, j);
+        };
+
+        auto runMix = [&](V* x, int n, int g, V wet, V dry) {
+            SLAMITY_TIME_STAGE(stageGainStage);
+            for (int j = 0; j < n; ++j)
+                x[j] = mixAt(g, wet, dry, x[j], stageDryBuf[j], j);
+        };
+
+        // --- Mackity ---
+        auto processMackity = [&](V* x, int n) {
+            if constexpr (mackMix) for (int j = 0; j < n; ++j) stageDryBuf[j] = x[j];
+
+            // High-pass IIR filter A (subsonic removal), then input trim
+            runHighPass(x, n, mackIirA, mackHighPassA, vMackA, vMackOneMinusA);
+            runGain(x, n, mackTrimGain, vMackInTrim);
+            meter(x, n, mackInTrimMeter);
+
+            // Biquad A lowpass
+            runBiquad(x, n, bqA, bqAx1, bqAx2, bqAy1, bqAy2);
+
+            // Soft saturation (5th-order polynomial waveshaper)
+            {
+                SLAMITY_TIME_STAGE(mackShaperStage);
+                const V shaperAmount = V::broadcast(0.1768);
+                for (int j = 0; j < n; ++j)
+                {
+                    V s = max(min(x[j], oneV), minusOneV);
+                    x[j] = s - pow5(s) * shaperAmount;
+                }
+            }
+
+            // Biquad B lowpass
+            runBiquad(x, n, bqB, bqBx1, bqBx2, bqBy1, bqBy2);
+
+            // High-pass IIR filter B (DC removal), then output pad
+            runHighPass(x, n, mackIirB, mackHighPassB, vMackB, vMackOneMinusB);
+            runGain(x, n, mackPadGain, vMackOutPad);
+            meter(x, n, mackOutPadMeter);
+
+            // Mackity dry/wet
+            if constexpr (mackMix) runMix(x, n, mackWetGain, vMackWet, vMackDry);
+        };
+
+        // --- DrumSlam ---
+        auto processDrumSlam = [&](V* x, int n) {
+            if constexpr (drumMix) for (int j = 0; j < n; ++j) stageDryBuf[j] = x[j];
+
+            runGain(x, n, drumDriveGain, vDrumDrive);
+            meter(x, n, drumDriveMeter);
+
+            // 3-band split. The original alternates between two independent
+            // filter sets (A/B/E/F, C/D/G/H) on successive samples, so these
+            // are two decimated streams: each iteration feeds one sample to
+            // each set, with no branch and two independent dependency chains
+            // for the CPU to overlap. fpFlip only says which set takes
+            // the first sample of the block. SlamityCrossoverTest holds this
+            // bit-identical to the per-sample alternation.
+            {
+                SLAMITY_TIME_STAGE(drumCrossoverStage);
+                struct SplitBank { V lowA, lowB, highA, highB; };
+
+                auto split = [&](SplitBank& bank, int j) {
+                    const V s = x[j];
+                    bank.lowA = (bank.lowA * vDrumOneMinusL) + (s * vDrumL);
+                    bank.lowB = (bank.lowB * vDrumOneMinusL) + (bank.lowA * vDrumL);
+                    lowBuf[j] = bank.lowB;
+
+                    bank.highA = (bank.highA * vDrumOneMinusH) + (s * vDrumH);
+                    bank.highB = (bank.highB * vDrumOneMinusH) + (bank.highA * vDrumH);
+                    midBuf[j] = bank.highB - bank.lowB;
+
+                    x[j] = s - bank.highB;
+                };
+
+                const SplitBank flipBank { drumA, drumB, drumE, drumF };
+                const SplitBank flopBank { drumC, drumD, drumG, drumH };
+                SplitBank even = drum.fpFlip ? flipBank : flopBank;
+                SplitBank odd = drum.fpFlip ? flopBank : flipBank;
+
+                if constexpr (Maths::blockFilters)
+                {
+                    // Each set's two cascaded one-poles run over its own
+                    // stream (stride 2), staging in the band buffers
+                    auto splitStream = [&](SplitBank& bank, int first) {
+                        const int count = (n - first + 1) / 2;
+                        drumSplitL.lowpass(x + first, lowBuf + first, count, 2, bank.lowA);
+                        drumSplitL.lowpass(lowBuf + first, lowBuf + first, count, 2, bank.lowB);
+                        drumSplitH.lowpass(x + first, midBuf + first, count, 2, bank.highA);
+                        drumSplitH.lowpass(midBuf + first, midBuf + first, count, 2, bank.highB);
+                    };
+                    splitStream(even, 0);
+                    splitStream(odd, 1);
+
+                    for (int j = 0; j < n; ++j)
+                    {
+                        const V high = midBuf[j];
+                        midBuf[j] = high - lowBuf[j];
+                        x[j] -= high;
+                    }
+                }
+                else
+                {
+                    int j = 0;
+                    for (; j + 1 < n; j += 2)
+                    {
+                        split(even, j);
+                        split(odd, j + 1);
+                    }
+                    if (j < n) split(even, j);
+                }
+
+                const SplitBank& newFlip = drum.fpFlip ? even : odd;
+                const SplitBank& newFlop = drum.fpFlip ? odd : even;
+                drumA = newFlip.lowA; drumB = newFlip.lowB; drumE = newFlip.highA; drumF = newFlip.highB;
+                drumC = newFlop.lowA; drumD = newFlop.lowB; drumG = newFlop.highA; drumH = newFlop.highB;
+
+                // An odd count hands the next sample to the other set
+                if (n & 1) drum.fpFlip = ! drum.fpFlip;
+            }
+
+            // Low and high band saturation
+            auto shapeBand = [&](V* band, V bandShape) {
+                for (int j = 0; j < n; ++j)
+                {
+                    V s = max(min(band[j], oneV), minusOneV);
+                    V shape = abs(s) * bandShape;
+                    s -= s * shape * shape;
+                    band[j] = s * gainAt(drumDriveGain, vDrumDrive, j);
+                }
+            };
+            {
+                SLAMITY_TIME_STAGE(drumLowShaperStage);
+                shapeBand(lowBuf, vLowShape);
+            }
+            {
+                SLAMITY_TIME_STAGE(drumHighShaperStage);
+                shapeBand(x, vHighShape);
+            }
+
+            // Mid band saturation with skew
+            {
+                SLAMITY_TIME_STAGE(drumMidShaperStage);
+                V last = drumLast;
+                for (int j = 0; j < n; ++j)
+                {
+                    const V drive = gainAt(drumDriveGain, vDrumDrive, j);
+                    V midSample = midBuf[j] * drive;
+
+                    V skew = midSample - last;
+                    last = midSample;
+                    V bridgerectifier = Maths::shaperSin(min(abs(skew), vPi));
+                    bridgerectifier = bridgerectifier * vPi;
+                    skew = select(skew > zeroV, bridgerectifier, -bridgerectifier);
+                    skew *= midSample;
+                    skew *= vSkewScale;
+                    bridgerectifier = abs(midSample);
+                    bridgerectifier += skew;
+                    bridgerectifier = Maths::shaperSin(min(bridgerectifier, vHalfPi));
+                    bridgerectifier *= drive;
+                    bridgerectifier += skew;
+                    bridgerectifier = Maths::shaperSin(min(bridgerectifier, vHalfPi));
+                    midBuf[j] = select(midSample > zeroV, bridgerectifier, -bridgerectifier);
+                }
+                drumLast = last;
+            }
+
+            // Recombine bands
+            {
+                SLAMITY_TIME_STAGE(drumRecombineStage);
+                for (int j = 0; j < n; ++j)
+                    x[j] = ((lowBuf[j] + midBuf[j] + x[j]) / gainAt(drumDriveGain, vDrumDrive, j))
+                             * gainAt(drumOutGain, vDrumOut, j);
+            }
+            meter(x, n, drumOutputMeter);
+
+            // DrumSlam dry/wet
+            if constexpr (drumMix) runMix(x, n, drumWetGain, vDrumWet, vDrumDry);
+        };
+
+        // --- Both stages in the selected chain order ---
+        auto processStages = [&](V* x, int n) {
+            if constexpr (mackFirstOrder) {
+                if constexpr (mackOn) processMackity(x, n);
+                if constexpr (drumOn) processDrumSlam(x, n);
+            } else {
+                if constexpr (drumOn) processDrumSlam(x, n);
+                if constexpr (mackOn) processMackity(x, n);
+            }
+        };
+
+        // --- Resampling, one stereo oversampler per lane pair ---
+        auto upsample = [&](V x, V* out) {
+            if constexpr (std::is_same_v<V, Vec2d>)
+            {
+                groupOversamplers[0].upsample(x, out);
+            }
+            else
+            {
+                alignas(32) double in[V::size];
+                alignas(32) double up[SlamityOversampler::maxFactor][V::size];
+                x.storeDoubles(in);
+                for (int p = 0; p < V::size / 2; ++p)
+                {
+                    Vec2d os[SlamityOversampler::maxFactor];
+                    groupOversamplers[p].upsample(Vec2d::load(in + 2 * p), os);
+                    for (int k = 0; k < osFactor; ++k) os[k].store(up[k] + 2 * p);
+                }
+                for (int k = 0; k < osFactor; ++k) out[k] = V::loadDoubles(up[k]);
+            }
+        };
+
+        auto downsample = [&](const V* in) -> V {
+            if constexpr (std::is_same_v<V, Vec2d>)
+            {
+                return groupOversamplers[0].downsample(in);
+            }
+            else
+            {
+                alignas(32) double os[SlamityOversampler::maxFactor][V::size];
+                alignas(32) double down[V::size];
+                for (int k = 0; k < osFactor; ++k) in[k].storeDoubles(os[k]);
+                for (int p = 0; p < V::size / 2; ++p)
+                {
+                    Vec2d pair[SlamityOversampler::maxFactor];
+                    for (int k = 0; k < osFactor; ++k) pair[k] = Vec2d::load(os[k] + 2 * p);
+                    groupOversamplers[p].downsample(pair).store(down + 2 * p);
+                }
+                return V::loadDoubles(down);
+            }
+        };
+
+        // =================================================================
+        // CHUNK LOOP: input -> (upsample) -> stages -> (downsample) -> output
+        // =================================================================
+        for (chunk = 0; chunk < sampleFrames; chunk += scratchFrames)
+        {
+            const int frames = std::min(scratchFrames, sampleFrames - chunk);
+
+            if constexpr (metering)
+                for (int m = 0; m < numMeterPoints; ++m)
+                    meterSum[m] = meterPeak[m] = zeroV;
+
+            // --- Input, with Airwindows denormal protection. The guard noise
+            // runs ahead on a copy of the dither state, which the output
+            // stage then advances the same way. Lanes past the last channel
+            // read silence and get no guard noise. ---
+            {
+                SLAMITY_TIME_STAGE(inputStage);
+                uint32_t guardState[V::size] = {};
+                for (int l = 0; l < numLanes; ++l) guardState[l] = state.fpd[base + l];
+
+                for (int i = 0; i < frames; ++i)
+                {
+                    alignas(32) Scalar in[V::size] = {}, noise[V::size] = {};
+                    for (int l = 0; l < numLanes; ++l)
+                    {
+                        uint32_t& f = guardState[l];
+                        in[l] = (Scalar)lanes[l][chunk + i];
+                        noise[l] = (Scalar)f;
+                        f ^= f << 13; f ^= f >> 17; f ^= f << 5;
+                    }
+                    const V inputSample = V::load(in);
+                    const V guard = V::load(noise) * vGuardScale;
+                    hostBuf[i] = select(abs(inputSample) < denormalThreshold, guard, inputSample);
+                }
+            }
+
+            // --- Main dry path, delayed by the resampling latency if any ---
+            if constexpr (oversampled)
+            {
+                SLAMITY_TIME_STAGE(resamplingStage);
+                for (int i = 0; i < frames; ++i)
+                {
+                    double* delayed = state.latency.dryDelay[delayPos] + base;
+                    mainDryBuf[i] = V::loadDoubles(delayed);
+                    hostBuf[i].storeDoubles(delayed);
+                    if (++delayPos == dryDelayLength) delayPos = 0;
+                }
+
+                for (int i = 0; i < frames; ++i)
+                    upsample(hostBuf[i], stageBuf + i * osFactor);
+            }
+            else if constexpr (mainMix)
+            {
+                SLAMITY_TIME_STAGE(mainMixStage);
+                for (int i = 0; i < frames; ++i) mainDryBuf[i] = hostBuf[i];
+            }
+
+            processStages(stageBuf, frames * osFactor);
+
+            if constexpr (oversampled)
+            {
+                SLAMITY_TIME_STAGE(resamplingStage);
+                for (int i = 0; i < frames; ++i)
+                    hostBuf[i] = downsample(stageBuf + i * osFactor);
+            }
+
+            // --- Main output gain and dry/wet ---
+            {
+                SLAMITY_TIME_STAGE(mainMixStage);
+                for (int i = 0; i < frames; ++i)
+                {
+                    V s = hostBuf[i];
+                    if constexpr (ramping) s *= V::broadcast(gainRamps[mainOutGain][chunk + i]);
+                    else s *= vMainOut;
+
+                    if constexpr (mainMix)
+                    {
+                        V wet = vMainWet, dry = vMainDry;
+                        if constexpr (ramping)
+                        {
+                            wet = V::broadcast(gainRamps[mainWetGain][chunk + i]);
+                            dry = oneV - wet;
+                        }
+                        s = (s * wet) + (mainDryBuf[i] * dry);
+                    }
+                    hostBuf[i] = s;
+                }
+            }
+            meter(hostBuf, frames, mainOutputMeter);
+
+            // --- This group's share of the chunk's meter totals. The stage
+            // meters see osFactor samples per host sample. ---
+            if constexpr (metering)
+            {
+                SLAMITY_TIME_STAGE(meteringStage);
+                MeterTotals& totals = meterChunks[(size_t)(chunk / scratchFrames)];
+                for (int m = 0; m < numMeterPoints; ++m)
+                {
+                    const double scale = m == mainOutputMeter ? 1.0 : 1.0 / osFactor;
+                    double sum = 0.0;
+                    for (int l = 0; l < V::size; ++l)
+                    {
+                        sum += (double)meterSum[m][l];
+                        totals.peak[m] = std::max(totals.peak[m], (float)meterPeak[m][l]);
+                    }
+                    totals.sumSquares[m] += sum * scale;
+                }
+                totals.numSamples = frames;
+            }
+
+            // --- TPDF dither (Airwindows convention), per channel. The noise
+            // source keeps running for double output, which is left
+            // undithered. ---
+            {
+                SLAMITY_TIME_STAGE(ditherStage);
+                for (int i = 0; i < frames; ++i)
+                {
+                    alignas(32) double out[V::size];
+                    hostBuf[i].storeDoubles(out);
+                    for (int l = 0; l < numLanes; ++l)
+                    {
+                        uint32_t& f = state.fpd[base + l];
+                        f ^= f << 13; f ^= f >> 17; f ^= f << 5;
+                        if constexpr (floatOutput) out[l] += Maths::ditherNoise(out[l], f);
+                        lanes[l][chunk + i] = (Sample)out[l];
+                    }
+                }
+            }
+        }
+
+        // Write state back
+        mackIirA.storeDoubles(mack.iirSampleA + base); mackIirB.storeDoubles(mack.iirSampleB + base);
+        bqAx1.storeDoubles(mack.biquadA[0] + base); bqAx2.storeDoubles(mack.biquadA[1] + base);
+        bqAy1.storeDoubles(mack.biquadA[2] + base); bqAy2.storeDoubles(mack.biquadA[3] + base);
+        bqBx1.storeDoubles(mack.biquadB[0] + base); bqBx2.storeDoubles(mack.biquadB[1] + base);
+        bqBy1.storeDoubles(mack.biquadB[2] + base); bqBy2.storeDoubles(mack.biquadB[3] + base);
+
+        drumA.storeDoubles(drum.iirSampleA + base); drumB.storeDoubles(drum.iirSampleB + base);
+        drumC.storeDoubles(drum.iirSampleC + base); drumD.storeDoubles(drum.iirSampleD + base);
+        drumE.storeDoubles(drum.iirSampleE + base); drumF.storeDoubles(drum.iirSampleF + base);
+        drumG.storeDoubles(drum.iirSampleG + base); drumH.storeDoubles(drum.iirSampleH + base);
+        drumLast.storeDoubles(drum.lastSample + base);
+    }
+
+    state.latency.dryDelayPos = delayPos;
+
+    // Fold the chunks into metering periods, in time order
+    if constexpr (metering)
+    {
+        SLAMITY_TIME_STAGE(meteringStage);
+        for (int chunkIndex = 0; chunkIndex * scratchFrames < sampleFrames; ++chunkIndex)
+            addMeterTotals(meterChunks[(size_t)chunkIndex]);
+    }
+}
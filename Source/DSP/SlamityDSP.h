@@ -0,0 +1,465 @@
+#pragma once
+
+#include "SlamityOversampler.h"
+#include "SlamityParameterRamp.h"
+#include "SlamityRing.h"
+
+#include <array>
+#include <cstdint>
+#if SLAMITY_STAGE_PROFILING
+ #include <chrono>
+#endif
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+// SlamityDSP: JUCE-free Mackity + DrumSlam processing core
+// DSP derived from Airwindows by Chris Johnson (MIT License)
+//
+// Call prepare() before processing, setParameters() whenever a control moves,
+// then process() blocks of float or double audio in place, on anything from
+// mono up to maxChannels channels. Apart from prepare(), nothing in here
+// allocates, locks or touches the host, so it can run from any render thread.
+//==============================================================================
+
+class SlamityDSP
+{
+public:
+    static constexpr int maxChannels = 16;     // enough for 7.1.4 / 9.1.6
+
+    // Parameter indices, in plugin order. Also the bit positions used by
+    // callers that track which parameters changed as a mask.
+    enum class ParamId
+    {
+        mackInTrim, mackOutPad, mackDryWet,
+        drumDrive, drumOutput, drumDryWet,
+        chainOrder, mainOutput, mainDryWet
+    };
+
+    static constexpr int numParameters = 9;
+
+    // Control values, in the same 0..1 ranges as the plugin parameters
+    struct Parameters
+    {
+        float mackInTrim = 0.1f;
+        float mackOutPad = 1.0f;
+        float mackDryWet = 1.0f;
+        float drumDrive  = 0.0f;
+        float drumOutput = 1.0f;
+        float drumDryWet = 1.0f;
+        float chainOrder = 0.0f;    // < 0.5 = Mackity > DrumSlam
+        float mainOutput = 1.0f;
+        float mainDryWet = 1.0f;
+
+        float& operator[](ParamId id)
+        {
+            switch (id)
+            {
+                case ParamId::mackInTrim: return mackInTrim;
+                case ParamId::mackOutPad: return mackOutPad;
+                case ParamId::mackDryWet: return mackDryWet;
+                case ParamId::drumDrive:  return drumDrive;
+                case ParamId::drumOutput: return drumOutput;
+                case ParamId::drumDryWet: return drumDryWet;
+                case ParamId::chainOrder: return chainOrder;
+                case ParamId::mainOutput: return mainOutput;
+                case ParamId::mainDryWet: break;
+            }
+            return mainDryWet;
+        }
+
+        float operator[](ParamId id) const { return const_cast<Parameters&>(*this)[id]; }
+    };
+
+    // A parameter change that lands on a given sample of the next process()
+    struct ParameterEvent
+    {
+        int sampleOffset = 0;
+        ParamId id = ParamId::mackInTrim;
+        float value = 0.0f;
+    };
+
+    // Metering points, in signal order through the default chain
+    enum MeterPoint
+    {
+        mackInTrimMeter, mackOutPadMeter,
+        drumDriveMeter, drumOutputMeter,
+        mainOutputMeter,
+        numMeterPoints
+    };
+
+    // Levels at each metering point over one metering period: at least
+    // meterPeriodSeconds of audio, rounded up to whole kernel chunks.
+    // Unscaled: any display calibration is left to the reader.
+    struct MeterFrame
+    {
+        float rms[numMeterPoints] = {};     // mean over channels
+        float peak[numMeterPoints] = {};    // highest over channels
+        uint32_t clipped = 0;               // bit per point: a sample reached full scale
+        int numSamples = 0;                 // host samples covered
+    };
+
+    static constexpr double meterPeriodSeconds = 0.01;
+    using MeterRing = SlamityRing<MeterFrame, 64>;
+
+    // Precise uses libm for the shapers and dither; Fast uses the bounded
+    // polynomial replacements documented in SlamityFastMath.h
+    enum class MathMode { precise, fast };
+
+    // The double kernel is the reference. The float kernel runs the same
+    // algorithm in single precision (with transposed direct form II biquads,
+    // which hold up better in float than the original direct form I) on
+    // twice as many lanes; for throughput-oriented offline renders of float
+    // audio. Double-precision I/O always uses the double kernel.
+    enum class Precision { doubleKernel, floatKernel };
+
+    //==============================================================================
+    // numChannels (1..maxChannels) is the width of every buffer passed to
+    // process(); each channel is processed independently, as with stereo.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels = 2);
+    void reset();
+
+    // Derived gains are only recomputed on the next process() after a change,
+    // then glide there over the smoothing time; sample-rate dependent filter
+    // coefficients only change in prepare()
+    void setParameters(const Parameters& newParams);
+    void setParameter(ParamId id, float value);
+    const Parameters& getParameters() const { return params; }
+
+    // Glide time for gain and mix changes; 0 makes them step immediately
+    void setSmoothingTime(double seconds);
+
+    // Runs both stages at 1x, 2x or 4x the host rate. Main gain, mix and
+    // dither stay at the host rate, and the dry path is delayed to match
+    // getLatencySamples(). Allocation-free, so it can be changed between
+    // process() calls on the audio thread; it restarts the filters.
+    void setOversamplingFactor(int factor);
+    int getOversamplingFactor() const { return state.latency.oversamplers[0].getFactor(); }
+    int getLatencySamples() const { return state.latency.oversamplers[0].getLatencySamples(); }
+
+    void setMathMode(MathMode newMode) { mathMode = newMode; }
+    MathMode getMathMode() const { return mathMode; }
+
+    // Switching precision restarts the filters
+    void setPrecision(Precision newPrecision);
+    Precision getPrecision() const { return precision; }
+
+    // Metering runs only while a ring is attached: process() then pushes a
+    // MeterFrame into it at the end of every metering period, dropping the
+    // frame if the reader has fallen behind. Pass nullptr to turn metering
+    // off; the kernel then has no metering code at all. The meters of a
+    // stage that is bypassed (see process()) read zero.
+    void setMeterOutput(MeterRing* ring);
+    bool isMeteringEnabled() const { return meterOutput != nullptr; }
+
+    // Processes getNumChannels() channels of numSamples samples in place.
+    // A stage whose dry/wet sits at 0 (or both, when the main dry/wet does)
+    // is skipped entirely; when it comes back its filters restart from
+    // silence and its output fades in.
+    void process(float* const* channels, int numSamples);
+
+    // As above, splitting the block so each event (sorted by sampleOffset)
+    // starts its glide on exactly that sample
+    void process(float* const* channels, int numSamples,
+                 const ParameterEvent* events, int numEvents);
+
+    // Double-precision I/O. Output is not dithered (the Airwindows 64-bit
+    // convention), since there is no float truncation to decorrelate.
+    void process(double* const* channels, int numSamples);
+    void process(double* const* channels, int numSamples,
+                 const ParameterEvent* events, int numEvents);
+
+    // Time the output takes to die away after the input goes silent. After
+    // that the processor sleeps: it outputs exact zeros and skips the DSP
+    // until non-silent input arrives.
+    double getTailLengthSeconds() const;
+    bool isSleeping() const { return state.sleeping; }
+
+    double getSampleRate() const { return sampleRate; }
+    int getNumChannels() const { return numChannels; }
+    int getMaxBlockSize() const { return maxBlockSize; }
+
+   #if SLAMITY_STAGE_PROFILING
+    // Builds with SLAMITY_STAGE_PROFILING (the kernel benchmark's copy of
+    // the library) can time each kernel stage. Timing reads the clock twice
+    // per stage per chunk, so it only runs while switched on here.
+    enum Stage
+    {
+        inputStage,                 // denormal guard and conversion in
+        resamplingStage,            // up/downsampling and the dry path delay
+        mackHighPassStage,          // IIR A and B
+        mackBiquadStage,            // biquad A and B
+        mackShaperStage,
+        drumCrossoverStage,
+        drumLowShaperStage,
+        drumMidShaperStage,
+        drumHighShaperStage,
+        drumRecombineStage,
+        stageGainStage,             // trims, pad, drive and stage dry/wet
+        mainMixStage,
+        meteringStage,
+        ditherStage,                // dither and conversion out
+        numStages
+    };
+
+    struct StageTimes { double nanoseconds[numStages] = {}; };
+
+    void setStageProfiling(bool shouldTime) { stageProfiling = shouldTime; }
+    const StageTimes& getStageTimes() const { return stageTimes; }
+    void resetStageTimes() { stageTimes = {}; }
+   #endif
+
+private:
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numChannels = 2;
+
+    Parameters params;
+    MathMode mathMode = MathMode::precise;
+    Precision precision = Precision::doubleKernel;
+    double guardNoiseScale = 1.18e-17;
+
+    // Filter coefficients, derived from the sample rate in prepare()
+    struct Coefficients
+    {
+        double mackIirAmountA = 0.0, mackIirAmountB = 0.0;
+        double mackBiquadA[7] = {};     // freq, Q, a0, a1, a2, b1, b2
+        double mackBiquadB[7] = {};
+
+        double drumIirAmountL = 0.0, drumIirAmountH = 0.0;
+    };
+
+    Coefficients coeffs;
+    bool mackFirst = true;
+    bool parametersChanged = true;
+
+    // Gains and mixes derived from the parameters, in kernel order. Each one
+    // ramps independently; while any of them moves the kernel reads per-sample
+    // values from rampBuffer instead of block constants.
+    enum Gain
+    {
+        mackTrimGain, mackPadGain, mackWetGain,
+        drumDriveGain, drumOutGain, drumWetGain,
+        mainOutGain, mainWetGain,
+        numGains
+    };
+
+    using Ramp = SlamityParameterRamp;      // the ramps themselves live in State
+    std::vector<double> rampBuffer;     // numGains * maxBlockSize
+    double smoothingSeconds = 0.02;
+    int rampSamples = 0;
+    int fadeInSamples = 0;              // minimum fade when a stage re-engages
+
+    // Metering: the kernel leaves per-chunk totals in meterChunks, which
+    // are folded into the current period in time order
+    struct MeterTotals
+    {
+        double sumSquares[numMeterPoints] = {};
+        float peak[numMeterPoints] = {};
+        int numSamples = 0;
+    };
+
+    MeterRing* meterOutput = nullptr;
+    std::vector<MeterTotals> meterChunks;   // one per kernel chunk of a segment
+    MeterTotals meterPeriod;
+    int meterPeriodSamples = 1;
+
+    void addMeterTotals(const MeterTotals& totals);
+
+    void clearFilterState();
+    void clearLatencyState();
+    void clearMackityState();
+    void clearDrumSlamState();
+    double getFilterStatePeak() const;
+
+    void updateRateCoefficients();
+    void updateParameterTargets(int rampLength);
+
+    template <typename Sample>
+    void processEvents(Sample* const* channels, int numSamples,
+                       const ParameterEvent* events, int numEvents);
+
+    template <typename Sample>
+    void processSegment(Sample* const* channels, int numSamples);
+
+    // Kernel specialisation flags, chosen once per segment so the stage
+    // loops have no branches on block-constant settings
+    enum KernelFlags : unsigned
+    {
+        mackFirstFlag  = 1,
+        mackMixFlag    = 2,
+        drumMixFlag    = 4,
+        mainMixFlag    = 8,
+        meteringFlag   = 16,
+        rampingFlag    = 32,
+        mackBypassFlag = 64,
+        drumBypassFlag = 128,
+        oversampledFlag = 256,
+        numKernelFlagCombinations = 512
+    };
+
+    // Maps every flag combination onto the kernel that actually has to be
+    // compiled for it, so redundant combinations share one instantiation.
+    // Only the default float I/O double kernel specialises on constant mixes;
+    // the other paths always mix, which keeps the code size in check.
+    static constexpr unsigned canonicalKernelFlags(unsigned flags, bool fullySpecialised)
+    {
+        if (! fullySpecialised) flags |= mackMixFlag | drumMixFlag | mainMixFlag;
+
+        // Oversampled kernels always mix and read per-sample gains; the
+        // stages dominate their cost
+        if (flags & oversampledFlag)
+        {
+            flags |= rampingFlag | mackMixFlag | drumMixFlag | mainMixFlag;
+            if ((flags & mackBypassFlag) && (flags & drumBypassFlag)) flags &= ~(unsigned)mackFirstFlag;
+            return flags;
+        }
+
+        // Ramping always mixes and never bypasses
+        if (flags & rampingFlag)
+            return (flags & (mackFirstFlag | meteringFlag)) | rampingFlag | mackMixFlag | drumMixFlag | mainMixFlag;
+
+        if (flags & mackBypassFlag) flags &= ~(unsigned)mackMixFlag;
+        if (flags & drumBypassFlag) flags &= ~(unsigned)drumMixFlag;
+        if ((flags & mackBypassFlag) && (flags & drumBypassFlag)) flags &= ~(unsigned)mackFirstFlag;
+        return flags;
+    }
+
+    template <typename Sample>
+    using KernelFn = void (SlamityDSP::*)(Sample* const*, int, const double* const*);
+
+    template <typename Maths, typename V, typename Sample, unsigned flags>
+    void processKernel(Sample* const* channels, int numSamples, const double* const* gainRamps);
+
+    template <typename Maths, typename V, typename Sample>
+    static KernelFn<Sample> getKernel(unsigned flags);
+
+    template <typename Maths, typename V, typename Sample, unsigned... flags>
+    static constexpr std::array<KernelFn<Sample>, sizeof...(flags)> makeKernelTable(std::integer_sequence<unsigned, flags...>)
+    {
+        constexpr bool fullySpecialised = std::is_same_v<V, Vec2d> && std::is_same_v<Sample, float>;
+        return { { &SlamityDSP::processKernel<Maths, V, Sample, canonicalKernelFlags(flags, fullySpecialised)>... } };
+    }
+
+    template <typename V, typename Sample>
+    KernelFn<Sample> getKernelForMathMode(unsigned flags) const;
+
+    // Planar work buffers for the block-staged kernel: one vector of lanes
+    // per sample, numScratchBuffers of them, each long enough for
+    // scratchFrames host frames at the highest oversampling factor. Longer
+    // segments are processed in chunks of scratchFrames, which keeps the
+    // working set in L1 whatever block size the host uses.
+    enum ScratchBufferId { hostSignal, mainDrySignal, stageSignal, stageDrySignal, lowBand, midBand, numScratchBuffers };
+    struct alignas(32) ScratchFrame { double lanes[4]; };   // fits any kernel vector type
+    static constexpr int maxScratchFrames = 256;
+    std::vector<ScratchFrame> scratch;
+    int scratchFrames = 0;
+
+    // All per-channel state is stored as one lane per channel, in host
+    // channel order, so the kernel can load and store a group of adjacent
+    // channels as one vector. The arrays always hold maxChannels lanes, a
+    // multiple of every vector width, so the last group can load them whole;
+    // lanes past numChannels stay at zero.
+    static_assert(maxChannels % 4 == 0, "state arrays must be a whole number of vectors");
+
+public:
+    //==============================================================================
+    // Everything the output depends on besides the parameters: filter and
+    // resampler histories, dither generators, gain ramp positions and the
+    // sleep / bypass flags. The structs are trivially copyable and
+    // cache-line aligned, so taking or restoring a snapshot is one memcpy
+    // (about 40 kB) -- e.g. to pre-roll offline render chunks, or to render
+    // from a point without replaying audio to warm the filters up.
+    struct alignas(64) MackityState
+    {
+        double iirSampleA[maxChannels] = {};
+        double iirSampleB[maxChannels] = {};
+        double biquadA[4][maxChannels] = {};    // x1, x2, y1, y2 (float kernel: s1, s2)
+        double biquadB[4][maxChannels] = {};
+    };
+
+    struct alignas(64) DrumSlamState
+    {
+        double iirSampleA[maxChannels] = {};
+        double iirSampleB[maxChannels] = {};
+        double iirSampleC[maxChannels] = {};
+        double iirSampleD[maxChannels] = {};
+        double iirSampleE[maxChannels] = {};
+        double iirSampleF[maxChannels] = {};
+        double iirSampleG[maxChannels] = {};
+        double iirSampleH[maxChannels] = {};
+        double lastSample[maxChannels] = {};
+        bool fpFlip = true;
+    };
+
+    // One oversampler per channel pair, and the matching dry path delay
+    struct alignas(64) LatencyState
+    {
+        SlamityOversampler oversamplers[maxChannels / 2];
+        alignas(32) double dryDelay[SlamityOversampler::maxLatencySamples][maxChannels] = {};
+        int dryDelayPos = 0;
+    };
+
+    struct alignas(64) State
+    {
+        // The configuration the state was taken under; setState() only
+        // accepts snapshots that match the current one
+        double sampleRate = 0.0;
+        int numChannels = 0;
+
+        MackityState mackity;
+        DrumSlamState drumSlam;
+        LatencyState latency;
+        uint32_t fpd[maxChannels] = {};     // TPDF dither generators
+
+        Ramp gains[numGains] {
+            Ramp { Ramp::Shape::exponential }, Ramp { Ramp::Shape::exponential }, Ramp { Ramp::Shape::linear },
+            Ramp { Ramp::Shape::linear },      Ramp { Ramp::Shape::exponential }, Ramp { Ramp::Shape::linear },
+            Ramp { Ramp::Shape::exponential }, Ramp { Ramp::Shape::linear }
+        };
+        bool sleeping = false;
+        bool mackBypassed = false, drumBypassed = false;
+    };
+
+    const State& getState() const { return state; }
+
+    // Restores a snapshot taken from an instance prepared with the same
+    // sample rate, channel count and oversampling factor, and returns true;
+    // otherwise leaves everything as it is and returns false. Parameters are
+    // not part of the state, so set those as well.
+    bool setState(const State& snapshot);
+
+private:
+    State state;
+
+   #if SLAMITY_STAGE_PROFILING
+    bool stageProfiling = false;
+    StageTimes stageTimes;
+
+    // Adds the time until it goes out of scope to one stage, when timing
+    class StageTimer
+    {
+    public:
+        StageTimer(SlamityDSP& dsp, Stage timedStage)
+            : times(dsp.stageProfiling ? &dsp.stageTimes : nullptr), stage(timedStage)
+        {
+            if (times != nullptr) start = Clock::now();
+        }
+
+        ~StageTimer()
+        {
+            if (times != nullptr)
+                times->nanoseconds[stage] += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        StageTimes* times;
+        Stage stage;
+        Clock::time_point start;
+    };
+   #endif
+
+    static_assert(std::is_trivially_copyable_v<State>, "snapshots are plain copies");
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "SlamitySIMD.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+//==============================================================================
+// Maths policies for the SlamityDSP kernel.
+//
+// PreciseMath makes the same libm calls as the original Airwindows code.
+// FastMath replaces them with branch-free approximations that vectorise:
+//
+//  - shaperSin: Cody-Waite reduction by pi into [-pi/2, pi/2], then a
+//    degree-11 odd minimax polynomial. Worst-case absolute error against
+//    std::sin is 1.4e-11 for |x| < 1e6 (the DrumSlam arguments are at most a
+//    few hundred), i.e. > 10 bits below the 24-bit float output LSB at 0 dBFS.
+//
+//  - ditherNoise: builds 2^(expon + 62) directly from the float exponent bits
+//    instead of frexpf() + pow(), and scales in double rather than long double.
+//    The dither values differ from PreciseMath by at most 1 ulp of the dither
+//    itself (~1e-23 at full scale).
+//
+//  - blockFilters: the one-pole filters (Mackity's DC / subsonic blockers
+//    and the DrumSlam crossover) run four samples per step through
+//    SlamityOnePole, whose error bound is documented there; in double it is
+//    far below the shaperSin error.
+//
+// End to end, FastMath output differs from PreciseMath by at most 3e-8
+// (-150 dBFS) per sample before the final rounding, across the full
+// parameter range at 44.1-192 kHz and every oversampling factor. Float
+// output can therefore round to the neighbouring float, one ulp of the
+// sample. Tests/SlamityFastMathTest.cpp enforces both bounds and the
+// shaperSin one.
+//
+// The Vec4f overloads serve the single-precision kernel. There the same
+// polynomial is evaluated in float; its absolute error stays below 2e-7 for
+// |x| < 300, on the order of the float filters' own rounding.
+//==============================================================================
+
+struct PreciseMath
+{
+    // Serial one-pole filters, as in the original. Deliberately not the
+    // block form: that one rounds differently, and PreciseMath is the
+    // bit-exact reference the other modes are measured against.
+    static constexpr bool blockFilters = false;
+
+    static Vec2d shaperSin(Vec2d x) { return sin(x); }
+    static Vec4f shaperSin(Vec4f x) { return sin(x); }
+   #if SLAMITY_SIMD_AVX
+    static Vec4d shaperSin(Vec4d x) { return sin(x); }
+   #endif
+
+    static double ditherNoise(double sample, uint32_t noise)
+    {
+        int expon; frexpf((float)sample, &expon);
+        return (double)((double(noise) - uint32_t(0x7fffffff)) * 5.5e-36l * pow(2, expon + 62));
+    }
+};
+
+//==============================================================================
+struct FastMath
+{
+    // One-pole filters run four samples per step (SlamityOnePole.h)
+    static constexpr bool blockFilters = true;
+
+    static Vec2d shaperSin(Vec2d x) { return shaperSinDouble(x); }
+   #if SLAMITY_SIMD_AVX
+    static Vec4d shaperSin(Vec4d x) { return shaperSinDouble(x); }
+   #endif
+
+    template <typename V>
+    static V shaperSinDouble(V x)
+    {
+        // k = round(x / pi) via the 1.5 * 2^52 trick (round-to-nearest)
+        const V roundMagic = V::broadcast(6755399441055744.0);
+        V k = (x * V::broadcast(0.31830988618379067154) + roundMagic) - roundMagic;
+
+        // r = x - k * pi, with pi split so k * piA is exact
+        V r = (x - k * V::broadcast(3.1415927410125732422))
+                - k * V::broadcast(-8.7422780003724823e-08);
+
+        // sin(x) = (-1)^k * sin(r); parity of k is |k - 2 * round(k / 2)|
+        V halfK = k * V::broadcast(0.5);
+        V parity = abs(k - V::broadcast(2.0) * ((halfK + roundMagic) - roundMagic));
+        V sign = V::broadcast(1.0) - V::broadcast(2.0) * parity;
+
+        V u = r * r;
+        V p = V::broadcast(-2.3794713545385453e-08);
+        p = p * u + V::broadcast(2.7518855638692766e-06);
+        p = p * u + V::broadcast(-0.00019840702862605969);
+        p = p * u + V::broadcast(0.0083333292644571545);
+        p = p * u + V::broadcast(-0.16666666541439165);
+        p = p * u + V::broadcast(0.99999999988985189);
+        return p * r * sign;
+    }
+
+    static Vec4f shaperSin(Vec4f x)
+    {
+        // As above with float constants: 1.5 * 2^23 rounds, and pi is split
+        // so k * piA stays exact for |k| < 2^16
+        const Vec4f roundMagic = Vec4f::broadcast(12582912.0);
+        Vec4f k = (x * Vec4f::broadcast(0.31830988618379067154) + roundMagic) - roundMagic;
+
+        Vec4f r = (x - k * Vec4f::broadcast(3.140625)) - k * Vec4f::broadcast(9.676535897932384626e-4);
+
+        Vec4f halfK = k * Vec4f::broadcast(0.5);
+        Vec4f parity = abs(k - Vec4f::broadcast(2.0) * ((halfK + roundMagic) - roundMagic));
+        Vec4f sign = Vec4f::broadcast(1.0) - Vec4f::broadcast(2.0) * parity;
+
+        Vec4f u = r * r;
+        Vec4f p = Vec4f::broadcast(-2.3794713545385453e-08);
+        p = p * u + Vec4f::broadcast(2.7518855638692766e-06);
+        p = p * u + Vec4f::broadcast(-0.00019840702862605969);
+        p = p * u + Vec4f::broadcast(0.0083333292644571545);
+        p = p * u + Vec4f::broadcast(-0.16666666541439165);
+        p = p * u + Vec4f::broadcast(0.99999999988985189);
+        return p * r * sign;
+    }
+
+    static double ditherNoise(double sample, uint32_t noise)
+    {
+        const float f = (float)sample;
+        uint32_t bits; std::memcpy(&bits, &f, sizeof(bits));
+        const int biased = (int)((bits >> 23) & 0xff);
+
+        // frexpf() semantics: zero gives 0, subnormals need normalising
+        int expon;
+        if (biased != 0) expon = biased - 126;
+        else if (f == 0.0f) expon = 0;
+        else frexpf(f, &expon);
+
+        const uint64_t scaleBits = (uint64_t)(expon + 62 + 1023) << 52;
+        double scale; std::memcpy(&scale, &scaleBits, sizeof(scale));
+
+        return (double(noise) - 2147483647.0) * (5.5e-36 * scale);
+    }
+};
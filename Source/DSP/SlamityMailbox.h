@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+//==============================================================================
+// Hands the latest value of T from one writer thread to one reader thread
+// (typically the audio thread) without locks or allocation.
+//
+// A triple buffer: the writer fills its private slot and swaps it into the
+// shared middle slot; the reader swaps the middle slot out when it holds
+// something new. Neither side ever waits, the reader always sees a complete
+// value, and a value written twice before the reader looks is simply
+// replaced by the newer one.
+//==============================================================================
+
+template <typename T>
+class SlamityMailbox
+{
+    static_assert(std::is_trivially_copyable_v<T>, "values are handed over by copy");
+
+public:
+    // Writer side
+    void post(const T& value)
+    {
+        slots[writeSlot] = value;
+        writeSlot = middle.exchange(writeSlot | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side: returns the newest value posted since the last call, or
+    // nullptr if there is none. The pointer stays valid until the next call.
+    const T* collect()
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+            return nullptr;
+
+        readSlot = middle.exchange(readSlot, std::memory_order_acq_rel) & indexMask;
+        return &slots[readSlot];
+    }
+
+private:
+    static constexpr int indexMask = 3, freshBit = 4;
+
+    T slots[3] {};
+    int writeSlot = 0, readSlot = 1;
+    std::atomic<int> middle { 2 };
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "SlamitySIMD.h"
+
+//==============================================================================
+// The Airwindows one-pole y[n] = y[n-1] * (1 - a) + x[n] * a, run over a
+// block four samples per step instead of one.
+//
+// Inside a step each output is a partial sum over the step's own inputs plus
+// a power of (1 - a) times the state carried in:
+//
+//   p[k] = p[k-1] * (1 - a) + x[k] * a          (p[-1] = 0)
+//   y[k] = p[k] + y[-1] * (1 - a)^(k + 1)        k = 0..3
+//
+// The partial sums don't depend on the carried state, so consecutive steps
+// overlap in the pipeline, and the loop-carried chain shrinks from four
+// multiply-adds to one. Lanes are still channels; the parallelism is along
+// time, within each lane.
+//
+// Accuracy against the serial recurrence: the powers of (1 - a) are rounded
+// once each and every output takes at most four more roundings than the
+// serial form. Those extra errors decay with the filter, so the difference
+// stays below 2 * eps * max|x| / a. In double (eps = 2^-53) that is 1.3e-11
+// of full scale for the slowest filter here (Mackity's DC blocker, a = 1.7e-5
+// at 4x 192 kHz); measured on noise it is 2e-14 at a = 7e-5 and 3e-16 at the
+// crossover's rates. In the float kernel (eps = 2^-24) it measures up to
+// 6e-6 for the DC blockers, the same order as the float filters' own error.
+// Tests/SlamityOnePoleTest.cpp enforces the double bound for every filter
+// and rate the kernel uses.
+//
+// Only FastMath uses this form. PreciseMath keeps the serial recurrence on
+// purpose, so that its output stays bit-identical to the original.
+//==============================================================================
+
+template <typename V>
+class SlamityOnePole
+{
+public:
+    static constexpr int samplesPerStep = 4;
+
+    // flushBelow > 0 zeroes the state whenever its magnitude drops under it,
+    // as Mackity does to keep the IIR out of denormals. The scan flushes once
+    // per step rather than per sample.
+    explicit SlamityOnePole(double amount, double flushBelow = 0.0)
+        : a(V::broadcast(amount)),
+          flushThreshold(V::broadcast(flushBelow)),
+          flush(flushBelow > 0.0)
+    {
+        const double b = 1.0 - amount;
+        double power = b;
+        for (int k = 0; k < samplesPerStep; ++k)
+        {
+            powers[k] = V::broadcast(power);    // (1 - a)^(k + 1)
+            power *= b;
+        }
+    }
+
+    // Lowpass of in[j * stride] into out[j * stride], for j < n. In place is
+    // fine: each step reads all of its inputs before writing.
+    void lowpass(const V* in, V* out, int n, int stride, V& state) const
+    {
+        run<false>(in, out, n, stride, state);
+    }
+
+    // in - lowpass(in), i.e. the DC / subsonic blocker
+    void highpass(const V* in, V* out, int n, int stride, V& state) const
+    {
+        run<true>(in, out, n, stride, state);
+    }
+
+private:
+    V a;
+    V powers[samplesPerStep];
+    V flushThreshold;
+    bool flush;
+
+    V flushed(V state) const
+    {
+        return flush ? select(abs(state) < flushThreshold, V::broadcast(0.0), state) : state;
+    }
+
+    template <bool highpass>
+    void run(const V* in, V* out, int n, int stride, V& state) const
+    {
+        const V b = powers[0];
+        V y = state;
+        int j = 0;
+
+        for (; j + samplesPerStep <= n; j += samplesPerStep)
+        {
+            const V x0 = in[(j + 0) * stride], x1 = in[(j + 1) * stride];
+            const V x2 = in[(j + 2) * stride], x3 = in[(j + 3) * stride];
+
+            const V p0 = x0 * a;
+            const V p1 = (p0 * b) + (x1 * a);
+            const V p2 = (p1 * b) + (x2 * a);
+            const V p3 = (p2 * b) + (x3 * a);
+
+            y = flushed(y);
+            const V y0 = (y * powers[0]) + p0;
+            const V y1 = (y * powers[1]) + p1;
+            const V y2 = (y * powers[2]) + p2;
+            y = (y * powers[3]) + p3;
+
+            out[(j + 0) * stride] = highpass ? x0 - y0 : y0;
+            out[(j + 1) * stride] = highpass ? x1 - y1 : y1;
+            out[(j + 2) * stride] = highpass ? x2 - y2 : y2;
+            out[(j + 3) * stride] = highpass ? x3 - y : y;
+        }
+
+        // Leftover samples take the serial form
+        for (; j < n; ++j)
+        {
+            const V x = in[j * stride];
+            y = (flushed(y) * b) + (x * a);
+            out[j * stride] = highpass ? x - y : y;
+        }
+
+        state = y;
+    }
+};
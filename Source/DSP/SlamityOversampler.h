@@ -0,0 +1,200 @@
+#pragma once
+
+#include "SlamitySIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+//==============================================================================
+// 2x / 4x oversampling for the SlamityDSP kernel, one stereo frame at a time.
+//
+// Each 2x step is a linear-phase half-band FIR split into its two polyphase
+// branches: one branch is a symmetric FIR over the low-rate samples, the other
+// a plain delay, so only the folded half of the non-zero taps is multiplied.
+// Both channels run together in the Vec2d lanes.
+//
+// Filters are Kaiser-windowed half-bands:
+//  - host <-> 2x: 59 taps, flat (+-0.0003 dB) to 0.4 x host rate, >= 90 dB
+//    rejection from 0.6 x host rate. Round trip latency 29 host samples.
+//  - 2x <-> 4x: 19 taps, flat to 0.2 x 2x rate, >= 84 dB from 0.8 x 2x rate.
+//    Round trip latency 9 samples at 2x, padded by one more so the 4x path
+//    is a whole number of host samples (34).
+//==============================================================================
+
+template <int numFoldedTaps>
+class SlamityHalfBand
+{
+public:
+    static constexpr int length = 4 * numFoldedTaps - 1;    // full FIR length
+    static constexpr int branchLength = 2 * numFoldedTaps;  // FIR branch taps
+
+    // Latency of one up + down round trip, in low-rate samples
+    static constexpr int roundTripLatency = branchLength - 1;
+
+    explicit SlamityHalfBand(const double (&outerToInnerTaps)[numFoldedTaps])
+    {
+        for (int j = 0; j < numFoldedTaps; ++j)
+            taps[j] = Vec2d::broadcast(outerToInnerTaps[j]);
+    }
+
+    void reset()
+    {
+        std::fill(std::begin(upHistory), std::end(upHistory), Vec2d::broadcast(0.0));
+        std::fill(std::begin(downEvenHistory), std::end(downEvenHistory), Vec2d::broadcast(0.0));
+        std::fill(std::begin(downOddHistory), std::end(downOddHistory), Vec2d::broadcast(0.0));
+        upPos = downPos = 0;
+        downPendingOdd = Vec2d::broadcast(0.0);
+    }
+
+    // One low-rate sample in, two high-rate samples out
+    void upsample(Vec2d x, Vec2d* out)
+    {
+        const Vec2d* h = push(upHistory, upPos, x);
+        out[0] = fir(h) * Vec2d::broadcast(2.0);
+        out[1] = h[branchLength - numFoldedTaps];  // x[n - (M - 1)]
+        upPos = upPos + 1 == branchLength ? 0 : upPos + 1;
+    }
+
+    // Two high-rate samples in, one low-rate sample out. The output lines up
+    // with the even input, so it pairs with the previous call's odd sample.
+    Vec2d downsample(const Vec2d* in)
+    {
+        const Vec2d* even = push(downEvenHistory, downPos, in[0]);
+        const Vec2d* odd = push(downOddHistory, downPos, downPendingOdd);
+        downPendingOdd = in[1];
+        downPos = downPos + 1 == branchLength ? 0 : downPos + 1;
+
+        return fir(even) + odd[branchLength - numFoldedTaps] * Vec2d::broadcast(0.5);
+    }
+
+    // Largest absolute value still held in the filter histories
+    double getPeak() const
+    {
+        double peak = 0.0;
+        auto scan = [&peak](Vec2d v) { peak = std::max({ peak, std::fabs(v[0]), std::fabs(v[1]) }); };
+        for (int i = 0; i < branchLength; ++i)
+        {
+            scan(upHistory[i]);
+            scan(downEvenHistory[i]);
+            scan(downOddHistory[i]);
+        }
+        scan(downPendingOdd);
+        return peak;
+    }
+
+private:
+    Vec2d taps[numFoldedTaps];
+
+    // Each history is written twice, at pos and pos + branchLength, so the
+    // latest branchLength samples are always contiguous: h[branchLength - 1]
+    // is the newest, h[0] the oldest.
+    Vec2d upHistory[2 * branchLength] {};
+    Vec2d downEvenHistory[2 * branchLength] {};
+    Vec2d downOddHistory[2 * branchLength] {};
+    Vec2d downPendingOdd {};
+    int upPos = 0, downPos = 0;
+
+    static const Vec2d* push(Vec2d* history, int pos, Vec2d x)
+    {
+        history[pos] = history[pos + branchLength] = x;
+        return history + pos + 1;
+    }
+
+    // Symmetric FIR over the branch, folding mirrored taps before multiplying
+    Vec2d fir(const Vec2d* h) const
+    {
+        Vec2d acc = taps[0] * (h[0] + h[branchLength - 1]);
+        for (int j = 1; j < numFoldedTaps; ++j)
+            acc += taps[j] * (h[j] + h[branchLength - 1 - j]);
+        return acc;
+    }
+};
+
+//==============================================================================
+class SlamityOversampler
+{
+    using Stage1 = SlamityHalfBand<15>;     // host <-> 2x
+    using Stage2 = SlamityHalfBand<5>;      // 2x <-> 4x
+
+public:
+    static constexpr int maxFactor = 4;
+    static constexpr int maxLatencySamples = Stage1::roundTripLatency + (Stage2::roundTripLatency + 1) / 2;
+
+    void setFactor(int newFactor)
+    {
+        factor = newFactor == 4 ? 4 : (newFactor == 2 ? 2 : 1);
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    // Round trip latency in host samples; the dry path is delayed to match
+    int getLatencySamples() const
+    {
+        if (factor == 1) return 0;
+        return factor == 2 ? Stage1::roundTripLatency : maxLatencySamples;
+    }
+
+    void reset()
+    {
+        stage1.reset();
+        stage2.reset();
+        stage2Pad = Vec2d::broadcast(0.0);
+    }
+
+    // One host sample in, factor samples out
+    void upsample(Vec2d x, Vec2d* out)
+    {
+        if (factor == 2)
+        {
+            stage1.upsample(x, out);
+            return;
+        }
+
+        Vec2d mid[2];
+        stage1.upsample(x, mid);
+        stage2.upsample(mid[0], out);
+        stage2.upsample(mid[1], out + 2);
+    }
+
+    // factor samples in, one host sample out
+    Vec2d downsample(const Vec2d* in)
+    {
+        if (factor == 2)
+            return stage1.downsample(in);
+
+        // One 2x sample of padding keeps the total latency a whole number of
+        // host samples
+        Vec2d mid[2];
+        mid[0] = stage2Pad;
+        mid[1] = stage2.downsample(in);
+        stage2Pad = stage2.downsample(in + 2);
+        return stage1.downsample(mid);
+    }
+
+    double getPeak() const
+    {
+        const double pad = std::max(std::fabs(stage2Pad[0]), std::fabs(stage2Pad[1]));
+        return std::max({ stage1.getPeak(), stage2.getPeak(), pad });
+    }
+
+private:
+    static constexpr double stage1Taps[15] = {
+        9.13368308496513e-06, -6.231278510158235e-05, 0.000204406963756306,
+        -0.0005110392011855872, 0.001091365877286488, -0.0020934915233284316,
+        0.00371087537001274, -0.006194225030551962, 0.009879672178856753,
+        -0.015259316651750924, 0.023164397359538753, -0.03528737272345064,
+        0.0559858278274969, -0.1013286863692241, 0.3166907650245603
+    };
+
+    static constexpr double stage2Taps[5] = {
+        5.1770886632702506e-05, -0.002465571229928649, 0.016725265657661862,
+        -0.06727361833581086, 0.3029621530214449
+    };
+
+    int factor = 1;
+    Stage1 stage1 { stage1Taps };
+    Stage2 stage2 { stage2Taps };
+    Vec2d stage2Pad {};
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cmath>
+
+//==============================================================================
+// A parameter value that glides to a new target over a fixed number of
+// samples, either linearly (mixes) or exponentially (gains).
+//
+// The ramp is rendered a block at a time into a caller-owned array with
+// fill(), so the audio kernel only ever reads plain per-sample values.
+//==============================================================================
+
+class SlamityParameterRamp
+{
+public:
+    enum class Shape { linear, exponential };
+
+    explicit SlamityParameterRamp(Shape rampShape = Shape::linear) : shape(rampShape) {}
+
+    // Jump straight to a value, cancelling any ramp in progress
+    void snapTo(double value)
+    {
+        current = target = value;
+        remaining = 0;
+    }
+
+    void setTarget(double newTarget, int rampSamples)
+    {
+        if (newTarget == target) return;
+        target = newTarget;
+
+        if (rampSamples <= 0 || current == target)
+        {
+            snapTo(target);
+            return;
+        }
+
+        remaining = rampSamples;
+
+        // Exponential ramps need both ends strictly positive; a fade to or
+        // from silence falls back to linear
+        useExponential = shape == Shape::exponential && current > 0.0 && target > 0.0;
+        step = useExponential ? std::pow(target / current, 1.0 / rampSamples)
+                              : (target - current) / rampSamples;
+    }
+
+    bool isRamping() const { return remaining > 0; }
+    double getCurrentValue() const { return current; }
+    double getTargetValue() const { return target; }
+
+    // Writes the next numSamples values to dest and advances the ramp
+    void fill(double* dest, int numSamples)
+    {
+        int i = 0;
+        const int rampPart = remaining < numSamples ? remaining : numSamples;
+
+        if (useExponential)
+        {
+            double v = current;
+            for (; i < rampPart; ++i) dest[i] = (v *= step);
+        }
+        else
+        {
+            const double start = current;
+            for (; i < rampPart; ++i) dest[i] = start + step * (i + 1);
+        }
+
+        remaining -= rampPart;
+        current = remaining == 0 ? target : dest[rampPart - 1];
+        if (remaining == 0 && rampPart > 0) dest[rampPart - 1] = target;
+
+        for (; i < numSamples; ++i) dest[i] = current;
+    }
+
+private:
+    Shape shape;
+    bool useExponential = false;
+    double current = 0.0, target = 0.0, step = 0.0;
+    int remaining = 0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "SlamityDSP.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+//==============================================================================
+// A fixed bank of named parameter sets, filled once with the factory presets.
+//
+// Recalling a preset only copies a SlamityDSP::Parameters out of the array,
+// so the audio thread can do it by index without allocating or locking; the
+// parameter values are never changed after construction. Names may be
+// edited, but only by the thread that owns the programs (not the audio
+// thread).
+//==============================================================================
+
+class SlamityPresetBank
+{
+public:
+    static constexpr int maxPresets = 32;
+    static constexpr int maxNameLength = 32;    // including the terminator
+
+    struct Preset
+    {
+        char name[maxNameLength] {};
+        SlamityDSP::Parameters params;
+    };
+
+    SlamityPresetBank()
+    {
+        // In Trim, Out Pad, Mack Dry/Wet, Drive, Output, Drum Dry/Wet,
+        // Chain Order, Main Output, Main Dry/Wet
+        add("Init",           { 0.10f, 1.00f, 1.00f, 0.00f, 1.00f, 1.00f, 0.0f, 1.00f, 1.00f });
+        add("Console Glue",   { 0.15f, 1.00f, 1.00f, 0.10f, 1.00f, 0.50f, 0.0f, 1.00f, 1.00f });
+        add("Warm Mix Bus",   { 0.12f, 1.00f, 0.60f, 0.00f, 1.00f, 1.00f, 0.0f, 1.00f, 1.00f });
+        add("Subtle Drive",   { 0.10f, 1.00f, 0.50f, 0.20f, 1.00f, 0.50f, 0.0f, 1.00f, 1.00f });
+        add("Drum Bus",       { 0.20f, 0.90f, 1.00f, 0.45f, 0.85f, 1.00f, 1.0f, 1.00f, 1.00f });
+        add("Snare Crack",    { 0.18f, 0.95f, 1.00f, 0.60f, 0.80f, 0.75f, 1.0f, 1.00f, 1.00f });
+        add("Parallel Smash", { 0.25f, 0.80f, 1.00f, 0.80f, 0.70f, 1.00f, 0.0f, 1.00f, 0.40f });
+        add("Crushed Room",   { 0.35f, 0.60f, 1.00f, 1.00f, 0.60f, 1.00f, 1.0f, 0.90f, 0.70f });
+    }
+
+    int size() const { return numPresets; }
+
+    // Out-of-range indices clamp to the nearest preset
+    const Preset& operator[](int index) const
+    {
+        return presets[(size_t)std::clamp(index, 0, numPresets - 1)];
+    }
+
+    void rename(int index, const char* newName)
+    {
+        if (index < 0 || index >= numPresets) return;
+        std::strncpy(presets[(size_t)index].name, newName, maxNameLength - 1);
+    }
+
+    // Parameters part way from a (amount 0) to b (amount 1). Continuous
+    // controls interpolate linearly; the chain order switches half way.
+    static SlamityDSP::Parameters morph(const SlamityDSP::Parameters& a,
+                                        const SlamityDSP::Parameters& b, float amount)
+    {
+        amount = std::clamp(amount, 0.0f, 1.0f);
+
+        SlamityDSP::Parameters result;
+        for (int i = 0; i < SlamityDSP::numParameters; ++i)
+        {
+            const auto id = (SlamityDSP::ParamId)i;
+            result[id] = a[id] + (b[id] - a[id]) * amount;
+        }
+        result.chainOrder = amount < 0.5f ? a.chainOrder : b.chainOrder;
+        return result;
+    }
+
+private:
+    std::array<Preset, maxPresets> presets {};
+    int numPresets = 0;
+
+    void add(const char* name, const SlamityDSP::Parameters& params)
+    {
+        if (numPresets == maxPresets) return;
+        presets[(size_t)numPresets++].params = params;
+        rename(numPresets - 1, name);
+    }
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+//==============================================================================
+// Fixed-capacity queue from one producer thread to one consumer thread
+// (typically audio thread to UI), without locks or allocation.
+//
+// Unlike SlamityMailbox, nothing is overwritten: every item pushed is popped
+// once, in order. A push onto a full ring fails and the item is dropped, so
+// a stalled consumer never blocks the producer.
+//==============================================================================
+
+template <typename T, int capacity>
+class SlamityRing
+{
+    static_assert(std::is_trivially_copyable_v<T>, "items are handed over by copy");
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops the item) when the ring is full.
+    bool push(const T& item)
+    {
+        const uint32_t write = writePos.load(std::memory_order_relaxed);
+        if (write - readPos.load(std::memory_order_acquire) == (uint32_t)capacity)
+            return false;
+
+        items[write & mask] = item;
+        writePos.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when there is nothing to pop.
+    bool pop(T& item)
+    {
+        const uint32_t read = readPos.load(std::memory_order_relaxed);
+        if (read == writePos.load(std::memory_order_acquire))
+            return false;
+
+        item = items[read & mask];
+        readPos.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr uint32_t mask = (uint32_t)capacity - 1;
+
+    // Each index on its own cache line, so the two threads don't contend
+    alignas(64) std::atomic<uint32_t> writePos { 0 };
+    alignas(64) std::atomic<uint32_t> readPos { 0 };
+    T items[capacity] {};
+};
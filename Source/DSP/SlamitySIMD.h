@@ -0,0 +1,356 @@
+#pragma once
+
+//==============================================================================
+// Minimal SIMD wrapper for the SlamityDSP kernels.
+//
+// Vec2d holds one double per stereo channel (lane 0 = L, lane 1 = R), so each
+// arithmetic operation processes both channels at once. Backed by SSE2 on
+// x86-64, NEON on Apple Silicon / AArch64, and plain scalars elsewhere.
+// Every arithmetic operation rounds exactly like the scalar expression it
+// replaces. The exception is pow5(), a multiply chain: it differs from
+// std::pow(x, 5) by up to 1 ulp, for about half of all inputs in [-1, 1].
+//
+// Vec4f is the same interface over four floats, for the single-precision
+// kernel. Both types can load and store their lanes from double arrays
+// (loadDoubles / storeDoubles), which is how the kernels keep one copy of
+// the filter state whatever the precision.
+//
+// Vec4d is four doubles on AVX, for layouts wider than stereo. It only
+// exists when the compiler targets AVX (see SLAMITY_ENABLE_AVX in
+// CMakeLists.txt); like Vec2d it avoids FMA, so its lanes are bit-identical
+// to the two-lane path.
+//==============================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SLAMITY_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+ #define SLAMITY_SIMD_NEON 1
+#endif
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+ #define SLAMITY_SIMD_AVX 1
+#endif
+
+#include <cmath>
+
+struct Vec2d
+{
+    using Scalar = double;
+    static constexpr int size = 2;
+
+   #if SLAMITY_SIMD_SSE2
+    __m128d v;
+
+    static Vec2d broadcast(double x)                { return { _mm_set1_pd(x) }; }
+    static Vec2d fromLanes(double l0, double l1)    { return { _mm_set_pd(l1, l0) }; }
+    static Vec2d load(const double* p)              { return { _mm_load_pd(p) }; }
+    void store(double* p) const                     { _mm_store_pd(p, v); }
+
+    friend Vec2d operator+(Vec2d a, Vec2d b)        { return { _mm_add_pd(a.v, b.v) }; }
+    friend Vec2d operator-(Vec2d a, Vec2d b)        { return { _mm_sub_pd(a.v, b.v) }; }
+    friend Vec2d operator*(Vec2d a, Vec2d b)        { return { _mm_mul_pd(a.v, b.v) }; }
+    friend Vec2d operator/(Vec2d a, Vec2d b)        { return { _mm_div_pd(a.v, b.v) }; }
+    friend Vec2d operator-(Vec2d a)                 { return { _mm_xor_pd(a.v, _mm_set1_pd(-0.0)) }; }
+
+    friend Vec2d min(Vec2d a, Vec2d b)              { return { _mm_min_pd(a.v, b.v) }; }
+    friend Vec2d max(Vec2d a, Vec2d b)              { return { _mm_max_pd(a.v, b.v) }; }
+    friend Vec2d abs(Vec2d a)                       { return { _mm_andnot_pd(_mm_set1_pd(-0.0), a.v) }; }
+
+    // Comparisons return an all-ones / all-zeros lane mask for select()
+    friend Vec2d operator<(Vec2d a, Vec2d b)        { return { _mm_cmplt_pd(a.v, b.v) }; }
+    friend Vec2d operator>(Vec2d a, Vec2d b)        { return { _mm_cmpgt_pd(a.v, b.v) }; }
+    friend Vec2d select(Vec2d mask, Vec2d a, Vec2d b)
+    {
+        return { _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v)) };
+    }
+   #elif SLAMITY_SIMD_NEON
+    float64x2_t v;
+
+    static Vec2d broadcast(double x)                { return { vdupq_n_f64(x) }; }
+    static Vec2d fromLanes(double l0, double l1)    { return { vsetq_lane_f64(l1, vdupq_n_f64(l0), 1) }; }
+    static Vec2d load(const double* p)              { return { vld1q_f64(p) }; }
+    void store(double* p) const                     { vst1q_f64(p, v); }
+
+    friend Vec2d operator+(Vec2d a, Vec2d b)        { return { vaddq_f64(a.v, b.v) }; }
+    friend Vec2d operator-(Vec2d a, Vec2d b)        { return { vsubq_f64(a.v, b.v) }; }
+    friend Vec2d operator*(Vec2d a, Vec2d b)        { return { vmulq_f64(a.v, b.v) }; }
+    friend Vec2d operator/(Vec2d a, Vec2d b)        { return { vdivq_f64(a.v, b.v) }; }
+    friend Vec2d operator-(Vec2d a)                 { return { vnegq_f64(a.v) }; }
+
+    friend Vec2d min(Vec2d a, Vec2d b)              { return { vminq_f64(a.v, b.v) }; }
+    friend Vec2d max(Vec2d a, Vec2d b)              { return { vmaxq_f64(a.v, b.v) }; }
+    friend Vec2d abs(Vec2d a)                       { return { vabsq_f64(a.v) }; }
+
+    friend Vec2d operator<(Vec2d a, Vec2d b)        { return { vreinterpretq_f64_u64(vcltq_f64(a.v, b.v)) }; }
+    friend Vec2d operator>(Vec2d a, Vec2d b)        { return { vreinterpretq_f64_u64(vcgtq_f64(a.v, b.v)) }; }
+    friend Vec2d select(Vec2d mask, Vec2d a, Vec2d b)
+    {
+        return { vbslq_f64(vreinterpretq_u64_f64(mask.v), a.v, b.v) };
+    }
+   #else
+    double v[2];
+
+    static Vec2d broadcast(double x)                { return { { x, x } }; }
+    static Vec2d fromLanes(double l0, double l1)    { return { { l0, l1 } }; }
+    static Vec2d load(const double* p)              { return { { p[0], p[1] } }; }
+    void store(double* p) const                     { p[0] = v[0]; p[1] = v[1]; }
+
+    friend Vec2d operator+(Vec2d a, Vec2d b)        { return { { a.v[0] + b.v[0], a.v[1] + b.v[1] } }; }
+    friend Vec2d operator-(Vec2d a, Vec2d b)        { return { { a.v[0] - b.v[0], a.v[1] - b.v[1] } }; }
+    friend Vec2d operator*(Vec2d a, Vec2d b)        { return { { a.v[0] * b.v[0], a.v[1] * b.v[1] } }; }
+    friend Vec2d operator/(Vec2d a, Vec2d b)        { return { { a.v[0] / b.v[0], a.v[1] / b.v[1] } }; }
+    friend Vec2d operator-(Vec2d a)                 { return { { -a.v[0], -a.v[1] } }; }
+
+    friend Vec2d min(Vec2d a, Vec2d b)              { return { { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1] } }; }
+    friend Vec2d max(Vec2d a, Vec2d b)              { return { { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1] } }; }
+    friend Vec2d abs(Vec2d a)                       { return { { std::fabs(a.v[0]), std::fabs(a.v[1]) } }; }
+
+    // Scalar masks use 1.0 / 0.0 rather than bit patterns
+    friend Vec2d operator<(Vec2d a, Vec2d b)        { return { { a.v[0] < b.v[0] ? 1.0 : 0.0, a.v[1] < b.v[1] ? 1.0 : 0.0 } }; }
+    friend Vec2d operator>(Vec2d a, Vec2d b)        { return { { a.v[0] > b.v[0] ? 1.0 : 0.0, a.v[1] > b.v[1] ? 1.0 : 0.0 } }; }
+    friend Vec2d select(Vec2d mask, Vec2d a, Vec2d b)
+    {
+        return { { mask.v[0] != 0.0 ? a.v[0] : b.v[0], mask.v[1] != 0.0 ? a.v[1] : b.v[1] } };
+    }
+   #endif
+
+    double operator[](int lane) const
+    {
+        alignas(16) double lanes[size];
+        store(lanes);
+        return lanes[lane];
+    }
+
+    // Lanewise std::sin; there is no vector libm to lean on here
+    friend Vec2d sin(Vec2d a)
+    {
+        alignas(16) double lanes[size];
+        a.store(lanes);
+        return fromLanes(std::sin(lanes[0]), std::sin(lanes[1]));
+    }
+
+    // Lanewise x^5 as (x*x)*(x*x)*x rather than a pow() call. Not
+    // bit-identical to std::pow(x, 5): up to 1 ulp apart.
+    friend Vec2d pow5(Vec2d a)
+    {
+        Vec2d a2 = a * a;
+        return a2 * a2 * a;
+    }
+
+    static Vec2d loadDoubles(const double* p)  { return load(p); }
+    void storeDoubles(double* p) const          { store(p); }
+
+    Vec2d& operator+=(Vec2d b) { return *this = *this + b; }
+    Vec2d& operator-=(Vec2d b) { return *this = *this - b; }
+    Vec2d& operator*=(Vec2d b) { return *this = *this * b; }
+};
+
+//==============================================================================
+struct Vec4f
+{
+    using Scalar = float;
+    static constexpr int size = 4;
+
+   #if SLAMITY_SIMD_SSE2
+    __m128 v;
+
+    static Vec4f broadcast(double x)                { return { _mm_set1_ps((float)x) }; }
+    static Vec4f fromLanes(double l0, double l1, double l2 = 0.0, double l3 = 0.0)
+    {
+        return { _mm_set_ps((float)l3, (float)l2, (float)l1, (float)l0) };
+    }
+    static Vec4f load(const float* p)               { return { _mm_load_ps(p) }; }
+    void store(float* p) const                      { _mm_store_ps(p, v); }
+
+    static Vec4f loadDoubles(const double* p)
+    {
+        return { _mm_movelh_ps(_mm_cvtpd_ps(_mm_load_pd(p)), _mm_cvtpd_ps(_mm_load_pd(p + 2))) };
+    }
+    void storeDoubles(double* p) const
+    {
+        _mm_store_pd(p, _mm_cvtps_pd(v));
+        _mm_store_pd(p + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+
+    friend Vec4f operator+(Vec4f a, Vec4f b)        { return { _mm_add_ps(a.v, b.v) }; }
+    friend Vec4f operator-(Vec4f a, Vec4f b)        { return { _mm_sub_ps(a.v, b.v) }; }
+    friend Vec4f operator*(Vec4f a, Vec4f b)        { return { _mm_mul_ps(a.v, b.v) }; }
+    friend Vec4f operator/(Vec4f a, Vec4f b)        { return { _mm_div_ps(a.v, b.v) }; }
+    friend Vec4f operator-(Vec4f a)                 { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+
+    friend Vec4f min(Vec4f a, Vec4f b)              { return { _mm_min_ps(a.v, b.v) }; }
+    friend Vec4f max(Vec4f a, Vec4f b)              { return { _mm_max_ps(a.v, b.v) }; }
+    friend Vec4f abs(Vec4f a)                       { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+    friend Vec4f operator<(Vec4f a, Vec4f b)        { return { _mm_cmplt_ps(a.v, b.v) }; }
+    friend Vec4f operator>(Vec4f a, Vec4f b)        { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    friend Vec4f select(Vec4f mask, Vec4f a, Vec4f b)
+    {
+        return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+    }
+   #elif SLAMITY_SIMD_NEON
+    float32x4_t v;
+
+    static Vec4f broadcast(double x)                { return { vdupq_n_f32((float)x) }; }
+    static Vec4f fromLanes(double l0, double l1, double l2 = 0.0, double l3 = 0.0)
+    {
+        alignas(16) const float lanes[size] = { (float)l0, (float)l1, (float)l2, (float)l3 };
+        return load(lanes);
+    }
+    static Vec4f load(const float* p)               { return { vld1q_f32(p) }; }
+    void store(float* p) const                      { vst1q_f32(p, v); }
+
+    static Vec4f loadDoubles(const double* p)
+    {
+        return { vcombine_f32(vcvt_f32_f64(vld1q_f64(p)), vcvt_f32_f64(vld1q_f64(p + 2))) };
+    }
+    void storeDoubles(double* p) const
+    {
+        vst1q_f64(p, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(p + 2, vcvt_high_f64_f32(v));
+    }
+
+    friend Vec4f operator+(Vec4f a, Vec4f b)        { return { vaddq_f32(a.v, b.v) }; }
+    friend Vec4f operator-(Vec4f a, Vec4f b)        { return { vsubq_f32(a.v, b.v) }; }
+    friend Vec4f operator*(Vec4f a, Vec4f b)        { return { vmulq_f32(a.v, b.v) }; }
+    friend Vec4f operator/(Vec4f a, Vec4f b)        { return { vdivq_f32(a.v, b.v) }; }
+    friend Vec4f operator-(Vec4f a)                 { return { vnegq_f32(a.v) }; }
+
+    friend Vec4f min(Vec4f a, Vec4f b)              { return { vminq_f32(a.v, b.v) }; }
+    friend Vec4f max(Vec4f a, Vec4f b)              { return { vmaxq_f32(a.v, b.v) }; }
+    friend Vec4f abs(Vec4f a)                       { return { vabsq_f32(a.v) }; }
+
+    friend Vec4f operator<(Vec4f a, Vec4f b)        { return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) }; }
+    friend Vec4f operator>(Vec4f a, Vec4f b)        { return { vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)) }; }
+    friend Vec4f select(Vec4f mask, Vec4f a, Vec4f b)
+    {
+        return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+    }
+   #else
+    float v[4];
+
+    static Vec4f broadcast(double x)                { const float f = (float)x; return { { f, f, f, f } }; }
+    static Vec4f fromLanes(double l0, double l1, double l2 = 0.0, double l3 = 0.0)
+    {
+        return { { (float)l0, (float)l1, (float)l2, (float)l3 } };
+    }
+    static Vec4f load(const float* p)               { return { { p[0], p[1], p[2], p[3] } }; }
+    void store(float* p) const                      { for (int i = 0; i < size; ++i) p[i] = v[i]; }
+
+    static Vec4f loadDoubles(const double* p)       { return fromLanes(p[0], p[1], p[2], p[3]); }
+    void storeDoubles(double* p) const              { for (int i = 0; i < size; ++i) p[i] = v[i]; }
+
+    template <typename Op>
+    static Vec4f lanewise(Vec4f a, Vec4f b, Op op)
+    {
+        return { { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) } };
+    }
+
+    friend Vec4f operator+(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x + y; }); }
+    friend Vec4f operator-(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x - y; }); }
+    friend Vec4f operator*(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x * y; }); }
+    friend Vec4f operator/(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x / y; }); }
+    friend Vec4f operator-(Vec4f a)                 { return { { -a.v[0], -a.v[1], -a.v[2], -a.v[3] } }; }
+
+    friend Vec4f min(Vec4f a, Vec4f b)              { return lanewise(a, b, [](float x, float y) { return x < y ? x : y; }); }
+    friend Vec4f max(Vec4f a, Vec4f b)              { return lanewise(a, b, [](float x, float y) { return x > y ? x : y; }); }
+    friend Vec4f abs(Vec4f a)                       { return lanewise(a, a, [](float x, float) { return std::fabs(x); }); }
+
+    friend Vec4f operator<(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x < y ? 1.0f : 0.0f; }); }
+    friend Vec4f operator>(Vec4f a, Vec4f b)        { return lanewise(a, b, [](float x, float y) { return x > y ? 1.0f : 0.0f; }); }
+    friend Vec4f select(Vec4f mask, Vec4f a, Vec4f b)
+    {
+        return { { mask.v[0] != 0.0f ? a.v[0] : b.v[0], mask.v[1] != 0.0f ? a.v[1] : b.v[1],
+                   mask.v[2] != 0.0f ? a.v[2] : b.v[2], mask.v[3] != 0.0f ? a.v[3] : b.v[3] } };
+    }
+   #endif
+
+    float operator[](int lane) const
+    {
+        alignas(16) float lanes[size];
+        store(lanes);
+        return lanes[lane];
+    }
+
+    friend Vec4f sin(Vec4f a)
+    {
+        alignas(16) float lanes[size];
+        a.store(lanes);
+        for (auto& x : lanes) x = std::sin(x);
+        return load(lanes);
+    }
+
+    friend Vec4f pow5(Vec4f a)
+    {
+        Vec4f a2 = a * a;
+        return a2 * a2 * a;
+    }
+
+    Vec4f& operator+=(Vec4f b) { return *this = *this + b; }
+    Vec4f& operator-=(Vec4f b) { return *this = *this - b; }
+    Vec4f& operator*=(Vec4f b) { return *this = *this * b; }
+};
+
+//==============================================================================
+#if SLAMITY_SIMD_AVX
+struct Vec4d
+{
+    using Scalar = double;
+    static constexpr int size = 4;
+
+    __m256d v;
+
+    static Vec4d broadcast(double x)                { return { _mm256_set1_pd(x) }; }
+    static Vec4d fromLanes(double l0, double l1, double l2 = 0.0, double l3 = 0.0)
+    {
+        return { _mm256_set_pd(l3, l2, l1, l0) };
+    }
+    static Vec4d load(const double* p)              { return { _mm256_load_pd(p) }; }
+    void store(double* p) const                     { _mm256_store_pd(p, v); }
+
+    static Vec4d loadDoubles(const double* p)       { return load(p); }
+    void storeDoubles(double* p) const              { store(p); }
+
+    friend Vec4d operator+(Vec4d a, Vec4d b)        { return { _mm256_add_pd(a.v, b.v) }; }
+    friend Vec4d operator-(Vec4d a, Vec4d b)        { return { _mm256_sub_pd(a.v, b.v) }; }
+    friend Vec4d operator*(Vec4d a, Vec4d b)        { return { _mm256_mul_pd(a.v, b.v) }; }
+    friend Vec4d operator/(Vec4d a, Vec4d b)        { return { _mm256_div_pd(a.v, b.v) }; }
+    friend Vec4d operator-(Vec4d a)                 { return { _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)) }; }
+
+    friend Vec4d min(Vec4d a, Vec4d b)              { return { _mm256_min_pd(a.v, b.v) }; }
+    friend Vec4d max(Vec4d a, Vec4d b)              { return { _mm256_max_pd(a.v, b.v) }; }
+    friend Vec4d abs(Vec4d a)                       { return { _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v) }; }
+
+    friend Vec4d operator<(Vec4d a, Vec4d b)        { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+    friend Vec4d operator>(Vec4d a, Vec4d b)        { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+    friend Vec4d select(Vec4d mask, Vec4d a, Vec4d b) { return { _mm256_blendv_pd(b.v, a.v, mask.v) }; }
+
+    double operator[](int lane) const
+    {
+        alignas(32) double lanes[size];
+        store(lanes);
+        return lanes[lane];
+    }
+
+    friend Vec4d sin(Vec4d a)
+    {
+        alignas(32) double lanes[size];
+        a.store(lanes);
+        for (auto& x : lanes) x = std::sin(x);
+        return load(lanes);
+    }
+
+    friend Vec4d pow5(Vec4d a)
+    {
+        Vec4d a2 = a * a;
+        return a2 * a2 * a;
+    }
+
+    Vec4d& operator+=(Vec4d b) { return *this = *this + b; }
+    Vec4d& operator-=(Vec4d b) { return *this = *this - b; }
+    Vec4d& operator*=(Vec4d b) { return *this = *this * b; }
+};
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//==============================================================================
+// The plugin's saved state: a flat list of plain parameter values (the
+// processor decides which, and in what order). Little-endian:
+//
+//   u32 magic "SLMY", u16 version, u16 count, count x float32
+//
+// Later versions may append values; a reader takes the ones it knows and
+// leaves the rest as they are. Kept free of JUCE so it can be tested and
+// timed on its own.
+//==============================================================================
+
+struct SlamityStateFormat
+{
+    static constexpr uint32_t magic = 0x594d4c53;
+    static constexpr int version = 1;
+    static constexpr size_t headerSize = 8;
+
+    static constexpr size_t sizeFor(int count) { return headerSize + (size_t)count * 4; }
+
+    // Writes sizeFor(count) bytes to dest
+    static void write(const float* values, int count, void* dest)
+    {
+        auto* bytes = static_cast<uint8_t*>(dest);
+        putLittleEndian(bytes, magic);
+        putLittleEndian16(bytes + 4, (uint16_t)version);
+        putLittleEndian16(bytes + 6, (uint16_t)count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &values[i], 4);
+            putLittleEndian(bytes + headerSize + (size_t)i * 4, bits);
+        }
+    }
+
+    // Reads up to numValues values into values. False (and values untouched)
+    // if the data isn't this format: wrong magic, version 0, or shorter than
+    // its header says. Values that aren't finite are skipped.
+    static bool read(const void* data, size_t size, float* values, int numValues)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        if (bytes == nullptr || size < headerSize || getLittleEndian(bytes) != magic)
+            return false;
+
+        const int storedVersion = getLittleEndian16(bytes + 4);
+        const int count = getLittleEndian16(bytes + 6);
+        if (storedVersion < 1 || size < sizeFor(count))
+            return false;
+
+        for (int i = 0; i < count && i < numValues; ++i)
+        {
+            const uint32_t bits = getLittleEndian(bytes + headerSize + (size_t)i * 4);
+            float value;
+            std::memcpy(&value, &bits, 4);
+            if (std::isfinite(value))
+                values[i] = value;
+        }
+        return true;
+    }
+
+private:
+    static void putLittleEndian(uint8_t* p, uint32_t v)
+    {
+        p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+    }
+
+    static void putLittleEndian16(uint8_t* p, uint16_t v)
+    {
+        p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+    }
+
+    static uint32_t getLittleEndian(const uint8_t* p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    static int getLittleEndian16(const uint8_t* p)
+    {
+        return (int)p[0] | ((int)p[1] << 8);
+    }
+};
@@ -1,20 +1,60 @@
 #include "PluginEditor.h"
 #include <cmath>
 
+namespace
+{
+    // Layout keys, one per entry in GUI/layout.txt
+    namespace L = SlamityLayoutTable;
+    using Key = SlamityLayout::Key;
+}
+
 //==============================================================================
 // VuMeterComponent implementation
 //==============================================================================
-void VuMeterComponent::setLevel(float linearRms)
+void VuMeterComponent::setLevel(float linearRms, float seconds)
 {
     targetDb = (linearRms > 1.0e-10f)
              ? 20.0f * std::log10(linearRms)
              : -60.0f;
 
-    // Exponential smoothing toward target (VU ballistics ~300ms)
-    const float coeff = 0.15f;
+    // Exponential smoothing toward target (VU ballistics ~300ms), scaled to
+    // the time the level covers
+    const float timeConstant = 0.205f;
+    const float coeff = 1.0f - std::exp(-seconds / timeConstant);
     currentDb += coeff * (targetDb - currentDb);
 
-    repaint();
+    // Repaint just the old and new needle, once the tip moves a pixel
+    const float angle = dbToAngle(currentDb);
+    const float tipMove = getNeedle(angle).getEnd().getDistanceFrom(getNeedle(drawnAngle).getEnd());
+    if (tipMove * juce::Component::getApproximateScaleFactorForComponent(this) <= 1.0f)
+        return;
+
+    repaint(getNeedleArea(drawnAngle).getUnion(getNeedleArea(angle)));
+    drawnAngle = angle;
+}
+
+juce::Line<float> VuMeterComponent::getNeedle(float angleDeg) const
+{
+    // Needle geometry — auto-calculated from component bounds
+    const auto bounds = getLocalBounds().toFloat();
+    const float pivotX = bounds.getCentreX();
+    const float pivotY = bounds.getHeight() * 0.88f;
+    const float needleLen = bounds.getHeight() * 0.72f;
+
+    // Needle tip (0 angle = straight up / 12 o'clock)
+    const float angleRad = juce::degreesToRadians(angleDeg);
+    return { pivotX, pivotY,
+             pivotX + needleLen * std::sin(angleRad),
+             pivotY - needleLen * std::cos(angleRad) };
+}
+
+juce::Rectangle<int> VuMeterComponent::getNeedleArea(float angleDeg) const
+{
+    // The line plus its shadow offset, line width and pivot cap
+    const auto needle = getNeedle(angleDeg);
+    return juce::Rectangle<float>(needle.getStart(), needle.getEnd())
+               .expanded(4.0f)
+               .getSmallestIntegerContainer();
 }
 
 float VuMeterComponent::dbToAngle(float db) const
@@ -52,24 +92,18 @@ float VuMeterComponent::dbToAngle(float db) const
 
 void VuMeterComponent::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds().toFloat();
-
-    // Draw VU background image scaled to fill bounds
-    if (meterImage.isValid())
-        g.drawImage(meterImage, bounds);
-
-    // Needle geometry — auto-calculated from component bounds
-    float pivotX = bounds.getCentreX();
-    float pivotY = bounds.getHeight() * 0.88f;
-    float needleLen = bounds.getHeight() * 0.72f;
-
-    // Convert current dB to angle
-    float angleDeg = dbToAngle(currentDb);
-    float angleRad = juce::degreesToRadians(angleDeg);
-
-    // Needle tip (0 angle = straight up / 12 o'clock)
-    float tipX = pivotX + needleLen * std::sin(angleRad);
-    float tipY = pivotY - needleLen * std::cos(angleRad);
+    // Meter face, scaled once per size and display scale (and shared by all
+    // the meters), then drawn 1:1
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto face = assets.getScaled(SlamityAssets::vuMeter,
+                                       juce::roundToInt((float)getWidth() * scale),
+                                       juce::roundToInt((float)getHeight() * scale));
+    if (face.isValid())
+        g.drawImageTransformed(face, juce::AffineTransform::scale(1.0f / scale));
+
+    const auto needle = getNeedle(drawnAngle);
+    const float pivotX = needle.getStartX(), pivotY = needle.getStartY();
+    const float tipX = needle.getEndX(), tipY = needle.getEndY();
 
     // Draw needle shadow
     g.setColour(juce::Colour(0x40000000));
@@ -86,17 +120,15 @@ void VuMeterComponent::paint(juce::Graphics& g)
 
 //==============================================================================
 SlamityEditor::SlamityEditor(SlamityProcessor& p)
-    : AudioProcessorEditor(&p), processorRef(p)
+    : AudioProcessorEditor(&p), processorRef(p), assets(SlamityAssets::getInstance())
 {
-    // Load background image
-    backgroundImage = juce::ImageCache::getFromMemory(BinaryData::GUI_BG_NoLabellogo_png,
-                                                       BinaryData::GUI_BG_NoLabellogo_pngSize);
-
-    // Set window size to match image
-    int w = backgroundImage.getWidth();
-    int h = backgroundImage.getHeight();
+    // Set window size to match the background image (known before it decodes)
+    const auto imageBounds = assets->getNativeBounds(SlamityAssets::background);
+    int w = imageBounds.getWidth();
+    int h = imageBounds.getHeight();
     if (w <= 0 || h <= 0) { w = 512; h = 512; }
     setSize(w, h);
+    setOpaque(true);
 
     // Configure all standard knobs
     setupKnob(mackInTrimSlider);
@@ -133,12 +165,27 @@ SlamityEditor::SlamityEditor(SlamityProcessor& p)
     addAndMakeVisible(vuDrumOutput);
     addAndMakeVisible(vuMainOut);
 
+    inTrimValue = processorRef.apvts.getRawParameterValue("mackInTrim");
+
+    // Skip frames left over from a previous editor
+    SlamityDSP::MeterFrame stale;
+    while (processorRef.meterFrames.pop(stale)) {}
+
+    // Debug builds re-read layout.txt when it is saved
+    layout.onChange = [this] { resized(); repaint(); };
+
+    // Redraw once the images have decoded
+    assets->addChangeListener(this);
+
+    processorRef.meteringActive.store(true, std::memory_order_relaxed);
     startTimerHz(30);
 }
 
 SlamityEditor::~SlamityEditor()
 {
     stopTimer();
+    assets->removeChangeListener(this);
+    processorRef.meteringActive.store(false, std::memory_order_relaxed);
     mackInTrimSlider.setLookAndFeel(nullptr);
     mackOutPadSlider.setLookAndFeel(nullptr);
     mackDryWetSlider.setLookAndFeel(nullptr);
@@ -162,11 +209,38 @@ void SlamityEditor::setupKnob(juce::Slider& slider)
 //==============================================================================
 void SlamityEditor::timerCallback()
 {
-    vuMackInTrim.setLevel(processorRef.vuMackInTrim.load(std::memory_order_relaxed));
-    vuMackOutPad.setLevel(processorRef.vuMackOutPad.load(std::memory_order_relaxed));
-    vuDrumDrive.setLevel(processorRef.vuDrumDrive.load(std::memory_order_relaxed));
-    vuDrumOutput.setLevel(processorRef.vuDrumOutput.load(std::memory_order_relaxed));
-    vuMainOut.setLevel(processorRef.vuMainOutput.load(std::memory_order_relaxed));
+    // Hidden or minimised: nothing to repaint, so don't meter either
+    const bool showing = isShowing();
+    processorRef.meteringActive.store(showing, std::memory_order_relaxed);
+    if (showing)
+        updateMeters();
+}
+
+void SlamityEditor::updateMeters()
+{
+    // Every frame since the last tick goes through the needle ballistics,
+    // with per-meter display calibration
+    const double sampleRate = processorRef.getSampleRate();
+    if (sampleRate <= 0.0) return;
+
+    const float inTrim = inTrimValue->load(std::memory_order_relaxed);
+    SlamityDSP::MeterFrame frame;
+    while (processorRef.meterFrames.pop(frame))
+    {
+        const float seconds = (float)(frame.numSamples / sampleRate);
+        const float* rms = frame.rms;
+        vuMackInTrim.setLevel(rms[SlamityDSP::mackInTrimMeter], seconds);                    // 1.0x (no change)
+        vuMackOutPad.setLevel(rms[SlamityDSP::mackOutPadMeter] * inTrim * 10.0f, seconds);   // scaled by In Trim
+        vuDrumDrive.setLevel(rms[SlamityDSP::drumDriveMeter] * 1.5f, seconds);               // +50%
+        vuDrumOutput.setLevel(rms[SlamityDSP::drumOutputMeter] * 1.75f, seconds);            // +75%
+        vuMainOut.setLevel(rms[SlamityDSP::mainOutputMeter] * 3.375f, seconds);              // +237.5%
+    }
+}
+
+void SlamityEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    staticLayer = {};
+    repaint();
 }
 
 //==============================================================================
@@ -200,54 +274,51 @@ void SlamityEditor::drawDymoLabel(juce::Graphics& g, juce::Rectangle<int> bounds
 }
 
 //==============================================================================
-std::map<juce::String, float> SlamityEditor::readLayoutFile() const
+void SlamityEditor::paint(juce::Graphics& g)
 {
-    std::map<juce::String, float> vals;
-    // Derive layout.txt path from this source file's compile-time location
-    auto file = juce::File(__FILE__).getParentDirectory()
-                    .getParentDirectory().getChildFile("GUI/layout.txt");
-    if (! file.existsAsFile()) return vals;
-
-    for (auto& line : juce::StringArray::fromLines(file.loadFileAsString()))
+    // Everything the editor itself draws is static: render it once per size
+    // and display scale, then composite it 1:1 under the controls
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (! staticLayer.isValid() || scale != staticLayerScale)
     {
-        auto trimmed = line.trimStart();
-        if (trimmed.isEmpty() || trimmed[0] == '#') continue;
-        auto eq = trimmed.indexOfChar('=');
-        if (eq < 0) continue;
-        vals[trimmed.substring(0, eq).trim()] = trimmed.substring(eq + 1).trim().getFloatValue();
+        const int w = juce::roundToInt((float)getWidth() * scale);
+        const int h = juce::roundToInt((float)getHeight() * scale);
+        if (w <= 0 || h <= 0) return;
+
+        staticLayer = juce::Image(juce::Image::ARGB, w, h, true);
+        staticLayerScale = scale;
+
+        juce::Graphics layer(staticLayer);
+        layer.addTransform(juce::AffineTransform::scale(scale));
+        layer.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+        paintStaticLayer(layer);
     }
-    return vals;
-}
 
-float SlamityEditor::lv(const std::map<juce::String, float>& m, const juce::String& key, float def)
-{
-    auto it = m.find(key);
-    return it != m.end() ? it->second : def;
+    g.drawImageTransformed(staticLayer, juce::AffineTransform::scale(1.0f / staticLayerScale));
 }
 
-//==============================================================================
-void SlamityEditor::paint(juce::Graphics& g)
+void SlamityEditor::paintStaticLayer(juce::Graphics& g)
 {
-    // Draw background image scaled to fill
-    if (backgroundImage.isValid())
-        g.drawImage(backgroundImage, getLocalBounds().toFloat());
+    // Draw background image scaled to fill, at the layer's pixel size
+    const auto background = assets->getScaled(SlamityAssets::background,
+                                              staticLayer.getWidth(), staticLayer.getHeight());
+    if (background.isValid())
+        g.drawImage(background, getLocalBounds().toFloat());
     else
         g.fillAll(juce::Colour(0xff1a1a1a));
 
-    auto L = readLayoutFile();
     auto w = getWidth();
     auto h = getHeight();
 
-    int labelH   = (int)lv(L, "labelH", 16.0f);
-    int labelW   = (int)(w * lv(L, "labelW", 0.18f));
-    int mdLabelW = (int)(w * lv(L, "mdLabelW", 0.06f));
-    int mdLabelH = (int)lv(L, "mdLabelH", 14.0f);
+    int labelH   = (int)layout[L::labelH];
+    int labelW   = (int)(w * layout[L::labelW]);
+    int mdLabelW = (int)(w * layout[L::mdLabelW]);
+    int mdLabelH = (int)layout[L::mdLabelH];
 
     // Helper: draw a label centred at (xFrac, yFrac)
-    auto label = [&](const char* xKey, float xDef, const char* yKey, float yDef,
-                     const juce::String& text, int lw, int lh) {
-        int cx = (int)(w * lv(L, xKey, xDef));
-        int y  = (int)(h * lv(L, yKey, yDef));
+    auto label = [&](Key xKey, Key yKey, const juce::String& text, int lw, int lh) {
+        int cx = (int)(w * layout[xKey]);
+        int y  = (int)(h * layout[yKey]);
         drawDymoLabel(g, { cx - lw / 2, y, lw, lh }, text);
     };
 
@@ -257,86 +328,84 @@ void SlamityEditor::paint(juce::Graphics& g)
     auto secFont = juce::Font(juce::Font::getDefaultMonospacedFontName(), secFontSize, juce::Font::bold);
     int secPad = secLabelH;
 
-    auto sectionLabel = [&](const char* xKey, float xDef, const char* yKey, float yDef,
-                            const juce::String& text) {
-        int cx = (int)(w * lv(L, xKey, xDef));
-        int y  = (int)(h * lv(L, yKey, yDef));
+    auto sectionLabel = [&](Key xKey, Key yKey, const juce::String& text) {
+        int cx = (int)(w * layout[xKey]);
+        int y  = (int)(h * layout[yKey]);
         int tw = (int)std::ceil(secFont.getStringWidthFloat(text)) + secPad;
         drawDymoLabel(g, { cx - tw / 2, y, tw, secLabelH }, text, secFontSize);
     };
 
-    sectionLabel("mackSectionLabel_x", 0.267f, "mackSectionLabel_y", 0.04f, "MACKITY");
-    sectionLabel("drumSectionLabel_x", 0.733f, "drumSectionLabel_y", 0.04f, "DRUMSLAM");
+    sectionLabel(L::mackSectionLabel_x, L::mackSectionLabel_y, "MACKITY");
+    sectionLabel(L::drumSectionLabel_x, L::drumSectionLabel_y, "DRUMSLAM");
 
     // Mackity labels
-    label("mackInTrimLabel_x", 0.165f, "mackInTrimLabel_y", 0.10f, "IN TRIM", labelW, labelH);
-    label("mackOutPadLabel_x", 0.165f, "mackOutPadLabel_y", 0.30f, "OUT PAD", labelW, labelH);
-    label("mackDryWetLabel_x", 0.165f, "mackDryWetLabel_y", 0.50f, "DRY/WET", labelW, labelH);
+    label(L::mackInTrimLabel_x, L::mackInTrimLabel_y, "IN TRIM", labelW, labelH);
+    label(L::mackOutPadLabel_x, L::mackOutPadLabel_y, "OUT PAD", labelW, labelH);
+    label(L::mackDryWetLabel_x, L::mackDryWetLabel_y, "DRY/WET", labelW, labelH);
 
     // DrumSlam labels
-    label("drumDriveLabel_x",  0.835f, "drumDriveLabel_y",  0.10f, "DRIVE",   labelW, labelH);
-    label("drumOutputLabel_x", 0.835f, "drumOutputLabel_y", 0.30f, "OUTPUT",  labelW, labelH);
-    label("drumDryWetLabel_x", 0.835f, "drumDryWetLabel_y", 0.50f, "DRY/WET", labelW, labelH);
+    label(L::drumDriveLabel_x,  L::drumDriveLabel_y,  "DRIVE",   labelW, labelH);
+    label(L::drumOutputLabel_x, L::drumOutputLabel_y, "OUTPUT",  labelW, labelH);
+    label(L::drumDryWetLabel_x, L::drumDryWetLabel_y, "DRY/WET", labelW, labelH);
 
     // Bottom row labels
-    label("mainDryWetLabel_x", 0.50f,  "mainDryWetLabel_y", 0.72f, "DRY/WET", labelW, labelH);
-    label("mainOutputLabel_x", 0.835f, "mainOutputLabel_y", 0.72f, "MAIN OUT", labelW, labelH);
+    label(L::mainDryWetLabel_x, L::mainDryWetLabel_y, "DRY/WET", labelW, labelH);
+    label(L::mainOutputLabel_x, L::mainOutputLabel_y, "MAIN OUT", labelW, labelH);
 
     // M > D / D > M labels
-    label("mdLeft_x",  0.12f, "mdLeft_y",  0.84f, "M > D", mdLabelW, mdLabelH);
-    label("mdRight_x", 0.21f, "mdRight_y", 0.84f, "D > M", mdLabelW, mdLabelH);
+    label(L::mdLeft_x, L::mdLeft_y, "M > D", mdLabelW, mdLabelH);
+    label(L::mdRight_x, L::mdRight_y, "D > M", mdLabelW, mdLabelH);
 }
 
 //==============================================================================
 void SlamityEditor::resized()
 {
-    auto L = readLayoutFile();
+    staticLayer = {};
+
     auto w = getWidth();
     auto h = getHeight();
 
-    int knobSize   = (int)(w * lv(L, "knobSize",   0.1155f));
-    int switchSize = (int)(w * lv(L, "switchSize",  0.091f));
+    int knobSize   = (int)(w * layout[L::knobSize]);
+    int switchSize = (int)(w * layout[L::switchSize]);
 
     // Helper: position a slider centred at (xFrac, yFrac top-edge)
-    auto place = [&](juce::Slider& s, const char* xKey, float xDef,
-                     const char* yKey, float yDef, int size) {
-        int cx = (int)(w * lv(L, xKey, xDef));
-        int y  = (int)(h * lv(L, yKey, yDef));
+    auto place = [&](juce::Slider& s, Key xKey, Key yKey, int size) {
+        int cx = (int)(w * layout[xKey]);
+        int y  = (int)(h * layout[yKey]);
         s.setBounds(cx - size / 2, y, size, size);
     };
 
     // Mackity knobs
-    place(mackInTrimSlider, "mackInTrimKnob_x", 0.165f, "mackInTrimKnob_y", 0.12f, knobSize);
-    place(mackOutPadSlider, "mackOutPadKnob_x", 0.165f, "mackOutPadKnob_y", 0.32f, knobSize);
-    place(mackDryWetSlider, "mackDryWetKnob_x", 0.165f, "mackDryWetKnob_y", 0.52f, knobSize);
+    place(mackInTrimSlider, L::mackInTrimKnob_x, L::mackInTrimKnob_y, knobSize);
+    place(mackOutPadSlider, L::mackOutPadKnob_x, L::mackOutPadKnob_y, knobSize);
+    place(mackDryWetSlider, L::mackDryWetKnob_x, L::mackDryWetKnob_y, knobSize);
 
     // DrumSlam knobs
-    place(drumDriveSlider,  "drumDriveKnob_x",  0.835f, "drumDriveKnob_y",  0.12f, knobSize);
-    place(drumOutputSlider, "drumOutputKnob_x",  0.835f, "drumOutputKnob_y", 0.32f, knobSize);
-    place(drumDryWetSlider, "drumDryWetKnob_x",  0.835f, "drumDryWetKnob_y", 0.52f, knobSize);
+    place(drumDriveSlider,  L::drumDriveKnob_x,  L::drumDriveKnob_y,  knobSize);
+    place(drumOutputSlider, L::drumOutputKnob_x, L::drumOutputKnob_y, knobSize);
+    place(drumDryWetSlider, L::drumDryWetKnob_x, L::drumDryWetKnob_y, knobSize);
 
     // Chain order switch
-    place(chainOrderSlider, "chainSwitch_x", 0.165f, "chainSwitch_y", 0.74f, switchSize);
+    place(chainOrderSlider, L::chainSwitch_x, L::chainSwitch_y, switchSize);
 
     // Bottom row knobs
-    place(mainDryWetSlider, "mainDryWetKnob_x", 0.50f,  "mainDryWetKnob_y", 0.74f, knobSize);
-    place(mainOutputSlider, "mainOutputKnob_x", 0.835f, "mainOutputKnob_y", 0.74f, knobSize);
+    place(mainDryWetSlider, L::mainDryWetKnob_x, L::mainDryWetKnob_y, knobSize);
+    place(mainOutputSlider, L::mainOutputKnob_x, L::mainOutputKnob_y, knobSize);
 
     // VU meters — height from layout, width from image aspect ratio
-    int vuH = (int)(w * lv(L, "vuH", 0.1155f));
+    int vuH = (int)(w * layout[L::vuH]);
     float vuAspect = vuMackInTrim.getImageAspectRatio();
     int vuW = (int)(vuH * vuAspect);
 
-    auto placeVu = [&](VuMeterComponent& vu, const char* xKey, float xDef,
-                        const char* yKey, float yDef) {
-        int cx = (int)(w * lv(L, xKey, xDef));
-        int y  = (int)(h * lv(L, yKey, yDef));
+    auto placeVu = [&](VuMeterComponent& vu, Key xKey, Key yKey) {
+        int cx = (int)(w * layout[xKey]);
+        int y  = (int)(h * layout[yKey]);
         vu.setBounds(cx - vuW / 2, y, vuW, vuH);
     };
 
-    placeVu(vuMackInTrim, "vuMackInTrim_x", 0.37f, "vuMackInTrim_y", 0.14f);
-    placeVu(vuDrumDrive,  "vuDrumDrive_x",  0.63f, "vuDrumDrive_y",  0.14f);
-    placeVu(vuMackOutPad, "vuMackOutPad_x",  0.37f, "vuMackOutPad_y",  0.34f);
-    placeVu(vuDrumOutput, "vuDrumOutput_x",  0.63f, "vuDrumOutput_y",  0.34f);
-    placeVu(vuMainOut,    "vuMainOutput_x",  0.50f, "vuMainOutput_y",  0.54f);
+    placeVu(vuMackInTrim, L::vuMackInTrim_x, L::vuMackInTrim_y);
+    placeVu(vuDrumDrive,  L::vuDrumDrive_x,  L::vuDrumDrive_y);
+    placeVu(vuMackOutPad, L::vuMackOutPad_x, L::vuMackOutPad_y);
+    placeVu(vuDrumOutput, L::vuDrumOutput_x, L::vuDrumOutput_y);
+    placeVu(vuMainOut,    L::vuMainOutput_x, L::vuMainOutput_y);
 }
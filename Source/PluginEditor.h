@@ -1,7 +1,8 @@
 #pragma once
 
 #include "PluginProcessor.h"
-#include <BinaryData.h>
+#include "SlamityAssets.h"
+#include "SlamityLayout.h"
 
 //==============================================================================
 // Image-based knob LookAndFeel — rotates Rotary.png based on slider position
@@ -10,42 +11,20 @@
 class KnobImageLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    KnobImageLookAndFeel()
-    {
-        knobImage = juce::ImageCache::getFromMemory(BinaryData::Rotary_png,
-                                                     BinaryData::Rotary_pngSize);
-    }
+    explicit KnobImageLookAndFeel(SlamityAssets& sharedAssets) : assets(sharedAssets) {}
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPosProportional, float rotaryStartAngle,
-                          float rotaryEndAngle, juce::Slider&) override
+                          float rotaryEndAngle, juce::Slider& slider) override
     {
-        if (! knobImage.isValid()) return;
-
-        // The angle the knob should be rotated to.
         // Image indicator is at 12 o'clock (0 rad). At 50% the angle is the
         // midpoint of start..end which for default JUCE rotary is 0 rad.
-        float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
-
-        auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat();
-        float side = juce::jmin(bounds.getWidth(), bounds.getHeight());
-        float cx = bounds.getCentreX();
-        float cy = bounds.getCentreY();
-
-        // Scale image to fit the knob area
-        float scale = side / (float)knobImage.getWidth();
-        float imgCx = knobImage.getWidth()  * 0.5f;
-        float imgCy = knobImage.getHeight() * 0.5f;
-
-        auto transform = juce::AffineTransform::rotation(angle, imgCx, imgCy)
-                             .scaled(scale)
-                             .translated(cx - imgCx * scale, cy - imgCy * scale);
-
-        g.drawImageTransformed(knobImage, transform, false);
+        assets.drawRotary(SlamityAssets::rotary, g, { x, y, width, height }, slider,
+                          sliderPosProportional, rotaryStartAngle, rotaryEndAngle);
     }
 
 private:
-    juce::Image knobImage;
+    SlamityAssets& assets;
 };
 
 //==============================================================================
@@ -55,38 +34,18 @@ private:
 class SwitchImageLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    SwitchImageLookAndFeel()
-    {
-        switchImage = juce::ImageCache::getFromMemory(BinaryData::Switch_png,
-                                                       BinaryData::Switch_pngSize);
-    }
+    explicit SwitchImageLookAndFeel(SlamityAssets& sharedAssets) : assets(sharedAssets) {}
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPosProportional, float rotaryStartAngle,
-                          float rotaryEndAngle, juce::Slider&) override
+                          float rotaryEndAngle, juce::Slider& slider) override
     {
-        if (! switchImage.isValid()) return;
-
-        float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
-
-        auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat();
-        float side = juce::jmin(bounds.getWidth(), bounds.getHeight());
-        float cx = bounds.getCentreX();
-        float cy = bounds.getCentreY();
-
-        float scale = side / (float)switchImage.getWidth();
-        float imgCx = switchImage.getWidth()  * 0.5f;
-        float imgCy = switchImage.getHeight() * 0.5f;
-
-        auto transform = juce::AffineTransform::rotation(angle, imgCx, imgCy)
-                             .scaled(scale)
-                             .translated(cx - imgCx * scale, cy - imgCy * scale);
-
-        g.drawImageTransformed(switchImage, transform, false);
+        assets.drawRotary(SlamityAssets::rotarySwitch, g, { x, y, width, height }, slider,
+                          sliderPosProportional, rotaryStartAngle, rotaryEndAngle);
     }
 
 private:
-    juce::Image switchImage;
+    SlamityAssets& assets;
 };
 
 //==============================================================================
@@ -95,33 +54,43 @@ private:
 class VuMeterComponent : public juce::Component
 {
 public:
-    VuMeterComponent()
+    explicit VuMeterComponent(SlamityAssets& sharedAssets) : assets(sharedAssets)
     {
-        meterImage = juce::ImageCache::getFromMemory(BinaryData::VU_png,
-                                                       BinaryData::VU_pngSize);
+        drawnAngle = dbToAngle(currentDb);
     }
 
     void paint(juce::Graphics& g) override;
-    void setLevel(float linearRms);
+
+    // Moves the needle toward a level measured over the given time. Only
+    // the area around the needle is repainted, and only once its tip has
+    // moved by more than a pixel.
+    void setLevel(float linearRms, float seconds);
 
     float getImageAspectRatio() const
     {
-        if (meterImage.isValid())
-            return (float)meterImage.getWidth() / (float)meterImage.getHeight();
+        const auto bounds = assets.getNativeBounds(SlamityAssets::vuMeter);
+        if (! bounds.isEmpty())
+            return (float)bounds.getWidth() / (float)bounds.getHeight();
         return 1.6f;
     }
 
 private:
-    juce::Image meterImage;
+    SlamityAssets& assets;
     float currentDb = -60.0f;
     float targetDb  = -60.0f;
+    float drawnAngle = 0.0f;            // needle angle of the last repaint
 
     float dbToAngle(float db) const;
+
+    // Needle pivot and tip for an angle, and the area its drawing covers
+    juce::Line<float> getNeedle(float angleDeg) const;
+    juce::Rectangle<int> getNeedleArea(float angleDeg) const;
 };
 
 //==============================================================================
 class SlamityEditor : public juce::AudioProcessorEditor,
-                      private juce::Timer
+                      private juce::Timer,
+                      private juce::ChangeListener
 {
 public:
     explicit SlamityEditor(SlamityProcessor&);
@@ -130,11 +99,26 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Moves the VU needles through every meter frame published since the
+    // last call. The timer does this while the editor is showing.
+    void updateMeters();
+
 private:
     void timerCallback() override;
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
     SlamityProcessor& processorRef;
 
-    juce::Image backgroundImage;
+    // Images shared with any other open editor; declared before everything
+    // that draws from them
+    SlamityAssets::Ptr assets;
+
+    // In Trim, for the Out Pad meter's calibration
+    std::atomic<float>* inTrimValue = nullptr;
+
+    // Background and labels, rendered at staticLayerScale by paintStaticLayer()
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+    void paintStaticLayer(juce::Graphics& g);
 
     // Mackity controls
     juce::Slider mackInTrimSlider;
@@ -163,15 +147,15 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mainDryWetAttach;
 
     // VU meter components
-    VuMeterComponent vuMackInTrim;
-    VuMeterComponent vuMackOutPad;
-    VuMeterComponent vuDrumDrive;
-    VuMeterComponent vuDrumOutput;
-    VuMeterComponent vuMainOut;
+    VuMeterComponent vuMackInTrim { *assets };
+    VuMeterComponent vuMackOutPad { *assets };
+    VuMeterComponent vuDrumDrive  { *assets };
+    VuMeterComponent vuDrumOutput { *assets };
+    VuMeterComponent vuMainOut    { *assets };
 
     // Custom L&F for knobs (image-based) and chain order switch
-    KnobImageLookAndFeel knobLnF;
-    SwitchImageLookAndFeel switchLnF;
+    KnobImageLookAndFeel knobLnF { *assets };
+    SwitchImageLookAndFeel switchLnF { *assets };
 
     // Helper to draw Dymo-style label tape
     void drawDymoLabel(juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& text, float fontSize = 10.5f) const;
@@ -179,9 +163,8 @@ private:
     // Helper to configure a standard rotary knob
     void setupKnob(juce::Slider& slider);
 
-    // Hot-reload layout values from GUI/layout.txt (dev tool)
-    std::map<juce::String, float> readLayoutFile() const;
-    static float lv(const std::map<juce::String, float>& m, const juce::String& key, float def);
+    // Positions and sizes from GUI/layout.txt
+    SlamityLayout layout;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlamityEditor)
 };
@@ -6,15 +6,81 @@
 // DSP derived from Airwindows by Chris Johnson (MIT License)
 //==============================================================================
 
+namespace
+{
+    // Parameter IDs in SlamityDSP::ParamId order
+    const char* const parameterIDs[SlamityDSP::numParameters] = {
+        "mackInTrim", "mackOutPad", "mackDryWet",
+        "drumDrive",  "drumOutput", "drumDryWet",
+        "chainOrder", "mainOutput", "mainDryWet"
+    };
+
+    // Saved state (SlamityStateFormat) holds every parameter's plain value,
+    // the SlamityDSP ones in ParamId order followed by the oversampling choice
+    constexpr int numStateValues = SlamityDSP::numParameters + 1;
+    using StateValues = std::array<float, numStateValues>;
+
+    const char* stateParameterID(int i)
+    {
+        return i < SlamityDSP::numParameters ? parameterIDs[i] : "oversampling";
+    }
+
+    // States saved before the binary format: the APVTS tree as XML, with a
+    // <PARAM id="..." value="..."/> child per parameter
+    bool readXmlState(const void* data, int sizeInBytes, const juce::Identifier& type, StateValues& values)
+    {
+        const auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+        if (xml == nullptr || ! xml->hasTagName(type.toString()))
+            return false;
+
+        for (auto* param : xml->getChildWithTagNameIterator("PARAM"))
+            for (int i = 0; i < numStateValues; ++i)
+                if (param->compareAttribute("id", stateParameterID(i)))
+                    values[(size_t)i] = (float)param->getDoubleAttribute("value", values[(size_t)i]);
+        return true;
+    }
+}
+
 SlamityProcessor::SlamityProcessor()
     : AudioProcessor(BusesProperties()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
+    for (int i = 0; i < SlamityDSP::numParameters; ++i)
+    {
+        paramValues[(size_t)i] = apvts.getRawParameterValue(parameterIDs[i]);
+
+        auto* param = apvts.getParameter(parameterIDs[i]);
+        jassert(param->getParameterIndex() == i);
+        param->addListener(this);
+    }
+
+    oversamplingValue = apvts.getRawParameterValue("oversampling");
 }
 
-SlamityProcessor::~SlamityProcessor() {}
+SlamityProcessor::~SlamityProcessor()
+{
+    stopTimer();
+    for (auto* id : parameterIDs)
+        apvts.getParameter(id)->removeListener(this);
+}
+
+// Called on whichever thread changed the parameter. The APVTS registered its
+// own listener first, so the raw value is already updated when the bit is set.
+void SlamityProcessor::parameterValueChanged(int parameterIndex, float)
+{
+    restoredUntouched.store(false, std::memory_order_relaxed);
+
+    // The morph's own host updates carry a morph the audio thread already
+    // has, or an older one while the morph is dragged: applying their raw
+    // values would pull the DSP back. (sendingMorph is only touched on the
+    // message thread, so test the thread first.)
+    if (juce::MessageManager::existsAndIsCurrentThread() && sendingMorph)
+        return;
+
+    dirtyParams.fetch_or(1u << parameterIndex, std::memory_order_release);
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout SlamityProcessor::createParameterLayout()
 {
@@ -59,6 +125,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout SlamityProcessor::createPara
         juce::ParameterID("mainDryWet", 1), "Main Dry/Wet",
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 1.0f));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversampling", 1), "Oversampling",
+        juce::StringArray { "1x", "2x", "4x" }, 0));
+
     return { params.begin(), params.end() };
 }
 
@@ -67,393 +137,233 @@ const juce::String SlamityProcessor::getName() const { return JucePlugin_Name; }
 bool SlamityProcessor::acceptsMidi() const { return false; }
 bool SlamityProcessor::producesMidi() const { return false; }
 bool SlamityProcessor::isMidiEffect() const { return false; }
-double SlamityProcessor::getTailLengthSeconds() const { return 0.0; }
-int SlamityProcessor::getNumPrograms() { return 1; }
-int SlamityProcessor::getCurrentProgram() { return 0; }
-void SlamityProcessor::setCurrentProgram(int) {}
-const juce::String SlamityProcessor::getProgramName(int) { return {}; }
-void SlamityProcessor::changeProgramName(int, const juce::String&) {}
+double SlamityProcessor::getTailLengthSeconds() const { return dsp.getTailLengthSeconds(); }
 
 //==============================================================================
-void SlamityProcessor::prepareToPlay(double, int)
+int SlamityProcessor::getNumPrograms() { return presets.size(); }
+int SlamityProcessor::getCurrentProgram() { return currentProgram.load(std::memory_order_relaxed); }
+
+void SlamityProcessor::setCurrentProgram(int index)
 {
-    // Reset Mackity state
-    mack_iirSampleAL = 0.0;
-    mack_iirSampleBL = 0.0;
-    mack_iirSampleAR = 0.0;
-    mack_iirSampleBR = 0.0;
-    std::fill(std::begin(mack_biquadA), std::end(mack_biquadA), 0.0);
-    std::fill(std::begin(mack_biquadB), std::end(mack_biquadB), 0.0);
-
-    // Reset DrumSlam state
-    drum_iirSampleAL = 0.0;
-    drum_iirSampleBL = 0.0;
-    drum_iirSampleCL = 0.0;
-    drum_iirSampleDL = 0.0;
-    drum_iirSampleEL = 0.0;
-    drum_iirSampleFL = 0.0;
-    drum_iirSampleGL = 0.0;
-    drum_iirSampleHL = 0.0;
-    drum_lastSampleL = 0.0;
-
-    drum_iirSampleAR = 0.0;
-    drum_iirSampleBR = 0.0;
-    drum_iirSampleCR = 0.0;
-    drum_iirSampleDR = 0.0;
-    drum_iirSampleER = 0.0;
-    drum_iirSampleFR = 0.0;
-    drum_iirSampleGR = 0.0;
-    drum_iirSampleHR = 0.0;
-    drum_lastSampleR = 0.0;
-    drum_fpFlip = true;
-
-    // Initialize TPDF dither state
-    fpdL = 1; while (fpdL < 16386) fpdL = (uint32_t)rand() * (uint32_t)UINT32_MAX;
-    fpdR = 1; while (fpdR < 16386) fpdR = (uint32_t)rand() * (uint32_t)UINT32_MAX;
+    // Some hosts re-select the current program straight after restoring
+    // state, which must not undo the restore. Any other selection loads the
+    // preset, even if it is the current program already.
+    index = juce::jlimit(0, presets.size() - 1, index);
+    const bool reselect = index == currentProgram.exchange(index, std::memory_order_relaxed);
+    if (restoredUntouched.exchange(false, std::memory_order_relaxed) && reselect)
+        return;
+
+    const auto& preset = presets[index].params;
+    pendingParams.post(preset);
+    morphHostPending.store(false, std::memory_order_relaxed);
+    setHostParameters(preset, false);
 }
 
-void SlamityProcessor::releaseResources() {}
+const juce::String SlamityProcessor::getProgramName(int index)
+{
+    return juce::String::fromUTF8(presets[index].name);
+}
 
-bool SlamityProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+void SlamityProcessor::changeProgramName(int index, const juce::String& newName)
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-    return true;
+    presets.rename(index, newName.toRawUTF8());
 }
 
-void SlamityProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void SlamityProcessor::storeSnapshot(Snapshot slot)
 {
-    juce::ScopedNoDenormals noDenormals;
+    snapshots[(size_t)slot] = getCurrentParameters();
+    pendingSnapshots.post(snapshots);
+}
 
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+void SlamityProcessor::recallSnapshot(Snapshot slot)
+{
+    setMorph(slot == Snapshot::a ? 0.0f : 1.0f);
+}
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+void SlamityProcessor::setMorph(float amount)
+{
+    amount = juce::jlimit(0.0f, 1.0f, amount);
+    morphAmount.store(amount, std::memory_order_release);
 
-    const int sampleFrames = buffer.getNumSamples();
-    if (sampleFrames == 0) return;
+    // The audio thread follows every move; the host hears of them at most
+    // morphHostRateHz times a second, which is all automation and the
+    // controls need while the morph is dragged
+    if (isTimerRunning())
+    {
+        morphHostPending.store(true, std::memory_order_relaxed);
+        return;
+    }
 
-    const double sr = getSampleRate();
-    double overallscale = 1.0;
-    overallscale /= 44100.0;
-    overallscale *= sr;
-
-    // --- Read all parameters ---
-    const float mackInTrimParam = *apvts.getRawParameterValue("mackInTrim");
-    const float mackOutPadParam = *apvts.getRawParameterValue("mackOutPad");
-    const float mackDryWetParam = *apvts.getRawParameterValue("mackDryWet");
-    const float drumDriveParam  = *apvts.getRawParameterValue("drumDrive");
-    const float drumOutputParam = *apvts.getRawParameterValue("drumOutput");
-    const float drumDryWetParam = *apvts.getRawParameterValue("drumDryWet");
-    const float chainOrderParam = *apvts.getRawParameterValue("chainOrder");
-    const float mainOutputParam = *apvts.getRawParameterValue("mainOutput");
-    const float mainDryWetParam = *apvts.getRawParameterValue("mainDryWet");
-
-    // =====================================================================
-    // MACKITY: Pre-block coefficient computation
-    // =====================================================================
-    double mackInTrim = mackInTrimParam * 10.0;
-    double mackOutPad = mackOutPadParam;
-    double mackWet = mackDryWetParam;
-    mackInTrim *= mackInTrim;
-
-    double mackIirAmountA = 0.001860867 / overallscale;
-    double mackIirAmountB = 0.000287496 / overallscale;
-
-    mack_biquadB[0] = mack_biquadA[0] = 19160.0 / sr;
-    mack_biquadA[1] = 0.431684981684982;
-    mack_biquadB[1] = 1.1582298;
-
-    double K = tan(juce::MathConstants<double>::pi * mack_biquadA[0]);
-    double norm = 1.0 / (1.0 + K / mack_biquadA[1] + K * K);
-    mack_biquadA[2] = K * K * norm;
-    mack_biquadA[3] = 2.0 * mack_biquadA[2];
-    mack_biquadA[4] = mack_biquadA[2];
-    mack_biquadA[5] = 2.0 * (K * K - 1.0) * norm;
-    mack_biquadA[6] = (1.0 - K / mack_biquadA[1] + K * K) * norm;
-
-    K = tan(juce::MathConstants<double>::pi * mack_biquadB[0]);
-    norm = 1.0 / (1.0 + K / mack_biquadB[1] + K * K);
-    mack_biquadB[2] = K * K * norm;
-    mack_biquadB[3] = 2.0 * mack_biquadB[2];
-    mack_biquadB[4] = mack_biquadB[2];
-    mack_biquadB[5] = 2.0 * (K * K - 1.0) * norm;
-    mack_biquadB[6] = (1.0 - K / mack_biquadB[1] + K * K) * norm;
-
-    // =====================================================================
-    // DRUMSLAM: Pre-block coefficient computation
-    // =====================================================================
-    double drumIirAmountL = 0.0819 / overallscale;
-    double drumIirAmountH = 0.377933067 / overallscale;
-    double drumDrive = (drumDriveParam * 3.0) + 1.0;
-    double drumOut = drumOutputParam;
-    double drumWet = drumDryWetParam;
-
-    // =====================================================================
-    // GLOBAL
-    // =====================================================================
-    double mainOutGain = mainOutputParam;
-    double mainWet = mainDryWetParam;
-    bool mackFirst = chainOrderParam < 0.5f;
-
-    // RMS accumulators for VU meters
-    double rmsAccMackTrim = 0.0, rmsAccMackPad = 0.0;
-    double rmsAccDrumDrive = 0.0, rmsAccDrumOut = 0.0;
-    double rmsAccMainOut = 0.0;
-
-    // --- Mackity processing lambda ---
-    auto processMackity = [&](double& sL, double& sR) {
-        double dryL = sL, dryR = sR;
-
-        // High-pass IIR filter A (subsonic removal)
-        if (fabs(mack_iirSampleAL) < 1.18e-37) mack_iirSampleAL = 0.0;
-        mack_iirSampleAL = (mack_iirSampleAL * (1.0 - mackIirAmountA)) + (sL * mackIirAmountA);
-        sL -= mack_iirSampleAL;
-        if (fabs(mack_iirSampleAR) < 1.18e-37) mack_iirSampleAR = 0.0;
-        mack_iirSampleAR = (mack_iirSampleAR * (1.0 - mackIirAmountA)) + (sR * mackIirAmountA);
-        sR -= mack_iirSampleAR;
-
-        // Input trim
-        if (mackInTrim != 1.0) { sL *= mackInTrim; sR *= mackInTrim; }
-        rmsAccMackTrim += sL * sL + sR * sR;
-
-        // Biquad A lowpass (DF1)
-        double outL = mack_biquadA[2]*sL + mack_biquadA[3]*mack_biquadA[7] + mack_biquadA[4]*mack_biquadA[8] - mack_biquadA[5]*mack_biquadA[9] - mack_biquadA[6]*mack_biquadA[10];
-        mack_biquadA[8] = mack_biquadA[7]; mack_biquadA[7] = sL; sL = outL; mack_biquadA[10] = mack_biquadA[9]; mack_biquadA[9] = sL;
-
-        double outR = mack_biquadA[2]*sR + mack_biquadA[3]*mack_biquadA[11] + mack_biquadA[4]*mack_biquadA[12] - mack_biquadA[5]*mack_biquadA[13] - mack_biquadA[6]*mack_biquadA[14];
-        mack_biquadA[12] = mack_biquadA[11]; mack_biquadA[11] = sR; sR = outR; mack_biquadA[14] = mack_biquadA[13]; mack_biquadA[13] = sR;
-
-        // Soft saturation (5th-order polynomial waveshaper)
-        if (sL > 1.0) sL = 1.0;
-        if (sL < -1.0) sL = -1.0;
-        sL -= pow(sL, 5) * 0.1768;
-        if (sR > 1.0) sR = 1.0;
-        if (sR < -1.0) sR = -1.0;
-        sR -= pow(sR, 5) * 0.1768;
-
-        // Biquad B lowpass (DF1)
-        outL = mack_biquadB[2]*sL + mack_biquadB[3]*mack_biquadB[7] + mack_biquadB[4]*mack_biquadB[8] - mack_biquadB[5]*mack_biquadB[9] - mack_biquadB[6]*mack_biquadB[10];
-        mack_biquadB[8] = mack_biquadB[7]; mack_biquadB[7] = sL; sL = outL; mack_biquadB[10] = mack_biquadB[9]; mack_biquadB[9] = sL;
-
-        outR = mack_biquadB[2]*sR + mack_biquadB[3]*mack_biquadB[11] + mack_biquadB[4]*mack_biquadB[12] - mack_biquadB[5]*mack_biquadB[13] - mack_biquadB[6]*mack_biquadB[14];
-        mack_biquadB[12] = mack_biquadB[11]; mack_biquadB[11] = sR; sR = outR; mack_biquadB[14] = mack_biquadB[13]; mack_biquadB[13] = sR;
-
-        // High-pass IIR filter B (DC removal)
-        if (fabs(mack_iirSampleBL) < 1.18e-37) mack_iirSampleBL = 0.0;
-        mack_iirSampleBL = (mack_iirSampleBL * (1.0 - mackIirAmountB)) + (sL * mackIirAmountB);
-        sL -= mack_iirSampleBL;
-        if (fabs(mack_iirSampleBR) < 1.18e-37) mack_iirSampleBR = 0.0;
-        mack_iirSampleBR = (mack_iirSampleBR * (1.0 - mackIirAmountB)) + (sR * mackIirAmountB);
-        sR -= mack_iirSampleBR;
-
-        // Output pad
-        if (mackOutPad != 1.0) { sL *= mackOutPad; sR *= mackOutPad; }
-        rmsAccMackPad += sL * sL + sR * sR;
-
-        // Mackity dry/wet
-        if (mackWet != 1.0) {
-            sL = (sL * mackWet) + (dryL * (1.0 - mackWet));
-            sR = (sR * mackWet) + (dryR * (1.0 - mackWet));
-        }
-    };
+    sendMorphToHost();
+    startTimerHz(morphHostRateHz);
+}
+
+void SlamityProcessor::sendMorphToHost()
+{
+    const float amount = morphAmount.load(std::memory_order_relaxed);
+    sendingMorph = true;
+    setHostParameters(SlamityPresetBank::morph(snapshots[0], snapshots[1], amount), true);
+    sendingMorph = false;
+}
+
+// Sends the latest morph if it moved since the last update, and stops once
+// a whole period passes without a move
+void SlamityProcessor::timerCallback()
+{
+    if (! morphHostPending.exchange(false, std::memory_order_relaxed))
+    {
+        stopTimer();
+        return;
+    }
 
-    // --- DrumSlam processing lambda ---
-    auto processDrumSlam = [&](double& sL, double& sR) {
-        double dryL = sL, dryR = sR;
+    sendMorphToHost();
+}
 
-        double lowSampleL, lowSampleR;
-        double midSampleL, midSampleR;
-        double highSampleL, highSampleR;
+SlamityDSP::Parameters SlamityProcessor::getCurrentParameters() const
+{
+    SlamityDSP::Parameters set;
+    for (int i = 0; i < SlamityDSP::numParameters; ++i)
+        set[(SlamityDSP::ParamId)i] = paramValues[(size_t)i]->load(std::memory_order_relaxed);
+    return set;
+}
 
-        sL *= drumDrive;
-        sR *= drumDrive;
-        rmsAccDrumDrive += sL * sL + sR * sR;
+// Moves the host parameters to a set the audio thread has already been
+// given, notifying the host and editor of the ones that change. A user edit
+// (a morph or A/B move) wraps the moves in one gesture, so the host records
+// them as a single edit; a restore or program change doesn't, so hosts in
+// touch or latch mode don't record loading a session as an edit.
+void SlamityProcessor::setHostParameters(const SlamityDSP::Parameters& set, bool userEdit)
+{
+    std::array<juce::RangedAudioParameter*, SlamityDSP::numParameters> moved {};
+    std::array<float, SlamityDSP::numParameters> values {};
+    int numMoved = 0;
 
-        // 3-band split with alternating filter sets
-        if (drum_fpFlip)
+    for (int i = 0; i < SlamityDSP::numParameters; ++i)
+    {
+        auto* param = apvts.getParameter(parameterIDs[i]);
+        const float normalised = param->convertTo0to1(set[(SlamityDSP::ParamId)i]);
+        if (normalised != param->getValue())
         {
-            drum_iirSampleAL = (drum_iirSampleAL * (1.0 - drumIirAmountL)) + (sL * drumIirAmountL);
-            drum_iirSampleBL = (drum_iirSampleBL * (1.0 - drumIirAmountL)) + (drum_iirSampleAL * drumIirAmountL);
-            lowSampleL = drum_iirSampleBL;
+            moved[(size_t)numMoved] = param;
+            values[(size_t)numMoved++] = normalised;
+        }
+    }
 
-            drum_iirSampleAR = (drum_iirSampleAR * (1.0 - drumIirAmountL)) + (sR * drumIirAmountL);
-            drum_iirSampleBR = (drum_iirSampleBR * (1.0 - drumIirAmountL)) + (drum_iirSampleAR * drumIirAmountL);
-            lowSampleR = drum_iirSampleBR;
+    if (userEdit)
+        for (int i = 0; i < numMoved; ++i)
+            moved[(size_t)i]->beginChangeGesture();
 
-            drum_iirSampleEL = (drum_iirSampleEL * (1.0 - drumIirAmountH)) + (sL * drumIirAmountH);
-            drum_iirSampleFL = (drum_iirSampleFL * (1.0 - drumIirAmountH)) + (drum_iirSampleEL * drumIirAmountH);
-            midSampleL = drum_iirSampleFL - drum_iirSampleBL;
+    for (int i = 0; i < numMoved; ++i)
+        moved[(size_t)i]->setValueNotifyingHost(values[(size_t)i]);
 
-            drum_iirSampleER = (drum_iirSampleER * (1.0 - drumIirAmountH)) + (sR * drumIirAmountH);
-            drum_iirSampleFR = (drum_iirSampleFR * (1.0 - drumIirAmountH)) + (drum_iirSampleER * drumIirAmountH);
-            midSampleR = drum_iirSampleFR - drum_iirSampleBR;
+    if (userEdit)
+        for (int i = 0; i < numMoved; ++i)
+            moved[(size_t)i]->endChangeGesture();
+}
 
-            highSampleL = sL - drum_iirSampleFL;
-            highSampleR = sR - drum_iirSampleFR;
-        }
-        else
-        {
-            drum_iirSampleCL = (drum_iirSampleCL * (1.0 - drumIirAmountL)) + (sL * drumIirAmountL);
-            drum_iirSampleDL = (drum_iirSampleDL * (1.0 - drumIirAmountL)) + (drum_iirSampleCL * drumIirAmountL);
-            lowSampleL = drum_iirSampleDL;
+//==============================================================================
+void SlamityProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    // The raw values below are at least as new as any pending set or morph
+    dirtyParams.store(0, std::memory_order_relaxed);
+    pendingParams.collect();
+    if (const auto* pair = pendingSnapshots.collect())
+        audioSnapshots = *pair;
+    appliedMorph = morphAmount.load(std::memory_order_acquire);
+    dsp.setParameters(getCurrentParameters());
+
+    dsp.prepare(sampleRate, samplesPerBlock, getMainBusNumOutputChannels());
+    dsp.setOversamplingFactor(getOversamplingFactor());
+    setLatencySamples(dsp.getLatencySamples());
+}
 
-            drum_iirSampleCR = (drum_iirSampleCR * (1.0 - drumIirAmountL)) + (sR * drumIirAmountL);
-            drum_iirSampleDR = (drum_iirSampleDR * (1.0 - drumIirAmountL)) + (drum_iirSampleCR * drumIirAmountL);
-            lowSampleR = drum_iirSampleDR;
+int SlamityProcessor::getOversamplingFactor() const
+{
+    return 1 << juce::jlimit(0, 2, (int)oversamplingValue->load(std::memory_order_relaxed));
+}
 
-            drum_iirSampleGL = (drum_iirSampleGL * (1.0 - drumIirAmountH)) + (sL * drumIirAmountH);
-            drum_iirSampleHL = (drum_iirSampleHL * (1.0 - drumIirAmountH)) + (drum_iirSampleGL * drumIirAmountH);
-            midSampleL = drum_iirSampleHL - drum_iirSampleDL;
+void SlamityProcessor::releaseResources() {}
 
-            drum_iirSampleGR = (drum_iirSampleGR * (1.0 - drumIirAmountH)) + (sR * drumIirAmountH);
-            drum_iirSampleHR = (drum_iirSampleHR * (1.0 - drumIirAmountH)) + (drum_iirSampleGR * drumIirAmountH);
-            midSampleR = drum_iirSampleHR - drum_iirSampleDR;
+bool SlamityProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Any layout from mono up to 7.1.4 (and beyond, up to the DSP's channel
+    // limit), as long as the input matches the output
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > SlamityDSP::maxChannels)
+        return false;
+    return layouts.getMainInputChannelSet() == output;
+}
 
-            highSampleL = sL - drum_iirSampleHL;
-            highSampleR = sR - drum_iirSampleHR;
-        }
-        drum_fpFlip = !drum_fpFlip;
-
-        // Low band saturation
-        if (lowSampleL > 1.0) lowSampleL = 1.0;
-        if (lowSampleL < -1.0) lowSampleL = -1.0;
-        if (lowSampleR > 1.0) lowSampleR = 1.0;
-        if (lowSampleR < -1.0) lowSampleR = -1.0;
-        lowSampleL -= (lowSampleL * (fabs(lowSampleL) * 0.448) * (fabs(lowSampleL) * 0.448));
-        lowSampleR -= (lowSampleR * (fabs(lowSampleR) * 0.448) * (fabs(lowSampleR) * 0.448));
-        lowSampleL *= drumDrive;
-        lowSampleR *= drumDrive;
-
-        // High band saturation
-        if (highSampleL > 1.0) highSampleL = 1.0;
-        if (highSampleL < -1.0) highSampleL = -1.0;
-        if (highSampleR > 1.0) highSampleR = 1.0;
-        if (highSampleR < -1.0) highSampleR = -1.0;
-        highSampleL -= (highSampleL * (fabs(highSampleL) * 0.599) * (fabs(highSampleL) * 0.599));
-        highSampleR -= (highSampleR * (fabs(highSampleR) * 0.599) * (fabs(highSampleR) * 0.599));
-        highSampleL *= drumDrive;
-        highSampleR *= drumDrive;
-
-        // Mid band saturation with skew
-        midSampleL *= drumDrive;
-        midSampleR *= drumDrive;
-
-        // Mid skew - left
-        double skew = (midSampleL - drum_lastSampleL);
-        drum_lastSampleL = midSampleL;
-        double bridgerectifier = fabs(skew);
-        if (bridgerectifier > 3.1415926) bridgerectifier = 3.1415926;
-        bridgerectifier = sin(bridgerectifier);
-        if (skew > 0) skew = bridgerectifier * 3.1415926;
-        else skew = -bridgerectifier * 3.1415926;
-        skew *= midSampleL;
-        skew *= 1.557079633;
-        bridgerectifier = fabs(midSampleL);
-        bridgerectifier += skew;
-        if (bridgerectifier > 1.57079633) bridgerectifier = 1.57079633;
-        bridgerectifier = sin(bridgerectifier);
-        bridgerectifier *= drumDrive;
-        bridgerectifier += skew;
-        if (bridgerectifier > 1.57079633) bridgerectifier = 1.57079633;
-        bridgerectifier = sin(bridgerectifier);
-        if (midSampleL > 0) midSampleL = bridgerectifier;
-        else midSampleL = -bridgerectifier;
-
-        // Mid skew - right
-        skew = (midSampleR - drum_lastSampleR);
-        drum_lastSampleR = midSampleR;
-        bridgerectifier = fabs(skew);
-        if (bridgerectifier > 3.1415926) bridgerectifier = 3.1415926;
-        bridgerectifier = sin(bridgerectifier);
-        if (skew > 0) skew = bridgerectifier * 3.1415926;
-        else skew = -bridgerectifier * 3.1415926;
-        skew *= midSampleR;
-        skew *= 1.557079633;
-        bridgerectifier = fabs(midSampleR);
-        bridgerectifier += skew;
-        if (bridgerectifier > 1.57079633) bridgerectifier = 1.57079633;
-        bridgerectifier = sin(bridgerectifier);
-        bridgerectifier *= drumDrive;
-        bridgerectifier += skew;
-        if (bridgerectifier > 1.57079633) bridgerectifier = 1.57079633;
-        bridgerectifier = sin(bridgerectifier);
-        if (midSampleR > 0) midSampleR = bridgerectifier;
-        else midSampleR = -bridgerectifier;
-
-        // Recombine bands
-        sL = ((lowSampleL + midSampleL + highSampleL) / drumDrive) * drumOut;
-        sR = ((lowSampleR + midSampleR + highSampleR) / drumDrive) * drumOut;
-        rmsAccDrumOut += sL * sL + sR * sR;
-
-        // DrumSlam dry/wet
-        if (drumWet != 1.0) {
-            sL = (sL * drumWet) + (dryL * (1.0 - drumWet));
-            sR = (sR * drumWet) + (dryR * (1.0 - drumWet));
-        }
-    };
+bool SlamityProcessor::supportsDoublePrecisionProcessing() const { return true; }
+
+void SlamityProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    processAudio(buffer);
+}
+
+// 64-bit hosts hand over doubles, which the DSP processes natively
+void SlamityProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processAudio(buffer);
+}
+
+template <typename Sample>
+void SlamityProcessor::processAudio(juce::AudioBuffer<Sample>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
 
-    // =====================================================================
-    // PER-SAMPLE PROCESSING LOOP
-    // =====================================================================
-    float* channelL = buffer.getWritePointer(0);
-    float* channelR = buffer.getWritePointer(1);
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
+
+    const int sampleFrames = buffer.getNumSamples();
+    if (sampleFrames == 0) return;
 
-    for (int i = 0; i < sampleFrames; ++i)
+    // --- Whole parameter sets first: a morph, then a restore or program ---
+    // A restore or program is published before its host parameters move, so
+    // once a dirty bit from one is seen the set is visible too. The morph's
+    // host updates set no dirty bits at all (see parameterValueChanged()).
+    // The raw values then only add whatever moved after them.
+    auto changed = dirtyParams.exchange(0, std::memory_order_acquire);
+
+    const float morph = morphAmount.load(std::memory_order_acquire);
+    if (const auto* pair = pendingSnapshots.collect())
+        audioSnapshots = *pair;
+    if (morph != appliedMorph)
     {
-        double inputSampleL = channelL[i];
-        double inputSampleR = channelR[i];
-
-        // Airwindows denormal protection
-        if (fabs(inputSampleL) < 1.18e-23) inputSampleL = fpdL * 1.18e-17;
-        if (fabs(inputSampleR) < 1.18e-23) inputSampleR = fpdR * 1.18e-17;
-
-        // Save for main dry/wet
-        double mainDryL = inputSampleL;
-        double mainDryR = inputSampleR;
-
-        // Process in selected chain order
-        if (mackFirst) {
-            processMackity(inputSampleL, inputSampleR);
-            processDrumSlam(inputSampleL, inputSampleR);
-        } else {
-            processDrumSlam(inputSampleL, inputSampleR);
-            processMackity(inputSampleL, inputSampleR);
-        }
+        appliedMorph = morph;
+        dsp.setParameters(SlamityPresetBank::morph(audioSnapshots[0], audioSnapshots[1], morph));
+    }
 
-        // Main output gain
-        inputSampleL *= mainOutGain;
-        inputSampleR *= mainOutGain;
+    if (const auto* set = pendingParams.collect())
+        dsp.setParameters(*set);
 
-        // Main dry/wet
-        if (mainWet != 1.0) {
-            inputSampleL = (inputSampleL * mainWet) + (mainDryL * (1.0 - mainWet));
-            inputSampleR = (inputSampleR * mainWet) + (mainDryR * (1.0 - mainWet));
-        }
-        rmsAccMainOut += inputSampleL * inputSampleL + inputSampleR * inputSampleR;
-
-        // TPDF dither (Airwindows convention)
-        int expon; frexpf((float)inputSampleL, &expon);
-        fpdL ^= fpdL << 13; fpdL ^= fpdL >> 17; fpdL ^= fpdL << 5;
-        inputSampleL += (double)((double(fpdL) - uint32_t(0x7fffffff)) * 5.5e-36l * pow(2, expon + 62));
-        frexpf((float)inputSampleR, &expon);
-        fpdR ^= fpdR << 13; fpdR ^= fpdR >> 17; fpdR ^= fpdR << 5;
-        inputSampleR += (double)((double(fpdR) - uint32_t(0x7fffffff)) * 5.5e-36l * pow(2, expon + 62));
-
-        channelL[i] = (float)inputSampleL;
-        channelR[i] = (float)inputSampleR;
+    // --- Then only the parameters that moved since the last block ---
+    for (int i = 0; changed != 0; ++i, changed >>= 1)
+        if (changed & 1u)
+            dsp.setParameter((SlamityDSP::ParamId)i, paramValues[(size_t)i]->load(std::memory_order_relaxed));
+
+    // --- Oversampling changes restart the filters and move the latency ---
+    const int oversampling = getOversamplingFactor();
+    if (oversampling != dsp.getOversamplingFactor())
+    {
+        dsp.setOversamplingFactor(oversampling);
+        setLatencySamples(dsp.getLatencySamples());
     }
 
-    // Store RMS levels for VU meters (mono sum: average of L+R)
-    double invN = 1.0 / (double)sampleFrames;
-    vuMackInTrim.store((float)std::sqrt(rmsAccMackTrim * invN * 0.5), std::memory_order_relaxed);              // 1.0x (no change)
-    vuMackOutPad.store((float)(std::sqrt(rmsAccMackPad * invN * 0.5) * mackInTrimParam * 10.0), std::memory_order_relaxed); // scaled by In Trim
-    vuDrumDrive.store((float)(std::sqrt(rmsAccDrumDrive * invN * 0.5) * 1.5), std::memory_order_relaxed);      // +50%
-    vuDrumOutput.store((float)(std::sqrt(rmsAccDrumOut * invN * 0.5) * 1.75), std::memory_order_relaxed);      // +75%
-    vuMainOutput.store((float)(std::sqrt(rmsAccMainOut * invN * 0.5) * 3.375), std::memory_order_relaxed);     // +237.5%
+    // A host that narrows the layout without preparing again hands over
+    // fewer channels than the DSP was prepared for: pass the block through
+    // untouched rather than read past the buffer's channel array
+    if (buffer.getNumChannels() < dsp.getNumChannels())
+    {
+        jassertfalse;
+        return;
+    }
+
+    dsp.setMeterOutput(meteringActive.load(std::memory_order_relaxed) ? &meterFrames : nullptr);
+    dsp.process(buffer.getArrayOfWritePointers(), sampleFrames);
 }
 
 //==============================================================================
@@ -467,17 +377,55 @@ juce::AudioProcessorEditor* SlamityProcessor::createEditor()
 //==============================================================================
 void SlamityProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    StateValues values;
+    for (int i = 0; i < numStateValues; ++i)
+    {
+        const auto* value = i < SlamityDSP::numParameters ? paramValues[(size_t)i] : oversamplingValue;
+        values[(size_t)i] = value->load(std::memory_order_relaxed);
+    }
+
+    destData.setSize(SlamityStateFormat::sizeFor(numStateValues));
+    SlamityStateFormat::write(values.data(), numStateValues, destData.getData());
 }
 
+// Called by the host, usually on the message thread while loading a session.
+// Only one thread may restore at a time (the mailbox has a single writer).
 void SlamityProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState != nullptr)
-        if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    StateValues values;
+    for (int i = 0; i < numStateValues; ++i)
+    {
+        const auto* param = apvts.getParameter(stateParameterID(i));
+        values[(size_t)i] = param->convertFrom0to1(param->getValue());
+    }
+
+    if (! SlamityStateFormat::read(data, (size_t)juce::jmax(0, sizeInBytes), values.data(), numStateValues)
+        && ! readXmlState(data, sizeInBytes, apvts.state.getType(), values))
+        return;
+
+    // Snap to each parameter's range and step, as setting it would
+    for (int i = 0; i < numStateValues; ++i)
+    {
+        const auto* param = apvts.getParameter(stateParameterID(i));
+        values[(size_t)i] = param->convertFrom0to1(param->convertTo0to1(values[(size_t)i]));
+    }
+
+    // The audio thread takes the whole set at its next block...
+    SlamityDSP::Parameters restored;
+    for (int i = 0; i < SlamityDSP::numParameters; ++i)
+        restored[(SlamityDSP::ParamId)i] = values[(size_t)i];
+    pendingParams.post(restored);
+    morphHostPending.store(false, std::memory_order_relaxed);
+
+    // ...then the host and editor hear about the parameters that moved
+    setHostParameters(restored, false);
+
+    auto* oversampling = apvts.getParameter(stateParameterID(SlamityDSP::numParameters));
+    const float normalised = oversampling->convertTo0to1(values[(size_t)SlamityDSP::numParameters]);
+    if (normalised != oversampling->getValue())
+        oversampling->setValueNotifyingHost(normalised);
+
+    restoredUntouched.store(true, std::memory_order_relaxed);
 }
 
 //==============================================================================
@@ -2,13 +2,19 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "DSP/SlamityDSP.h"
+#include "DSP/SlamityMailbox.h"
+#include "DSP/SlamityPresetBank.h"
+#include "DSP/SlamityStateFormat.h"
 
 //==============================================================================
 // Slamity: Combined Airwindows Mackity + DrumSlam plugin
 // DSP derived from Airwindows by Chris Johnson (MIT License)
 //==============================================================================
 
-class SlamityProcessor : public juce::AudioProcessor
+class SlamityProcessor : public juce::AudioProcessor,
+                         private juce::AudioProcessorParameter::Listener,
+                         private juce::Timer
 {
 public:
     //==============================================================================
@@ -22,6 +28,8 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -46,51 +54,86 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // A/B compare: two stored parameter sets and a morph between them. The
+    // audio thread computes the morph and hands the DSP the whole set at
+    // once; the host parameters follow, at most morphHostRateHz times a
+    // second while the morph moves, so the controls show where it is.
+    // Message thread only, like the program calls.
+    enum class Snapshot { a, b };
+
+    void storeSnapshot(Snapshot slot);      // takes the current parameters; the sound doesn't change
+    void recallSnapshot(Snapshot slot);     // same as setMorph(0) or setMorph(1)
+    void setMorph(float amount);            // 0 = A, 1 = B
+    float getMorph() const { return morphAmount.load(std::memory_order_relaxed); }
+
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
 
-    // RMS levels for VU meters (mono sum, updated per block)
-    std::atomic<float> vuMackInTrim{0.0f};
-    std::atomic<float> vuMackOutPad{0.0f};
-    std::atomic<float> vuDrumDrive{0.0f};
-    std::atomic<float> vuDrumOutput{0.0f};
-    std::atomic<float> vuMainOutput{0.0f};
+    // Meter frames for the VU meters, audio thread to editor. Filled only
+    // while meteringActive is set, which the editor does while it is open;
+    // otherwise the DSP does no metering at all.
+    SlamityDSP::MeterRing meterFrames;
+    std::atomic<bool> meteringActive{false};
 
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // --- Mackity DSP state ---
-    double mack_iirSampleAL = 0.0;
-    double mack_iirSampleBL = 0.0;
-    double mack_iirSampleAR = 0.0;
-    double mack_iirSampleBR = 0.0;
-    double mack_biquadA[15] = {};
-    double mack_biquadB[15] = {};
-
-    // --- DrumSlam DSP state ---
-    double drum_iirSampleAL = 0.0;
-    double drum_iirSampleBL = 0.0;
-    double drum_iirSampleCL = 0.0;
-    double drum_iirSampleDL = 0.0;
-    double drum_iirSampleEL = 0.0;
-    double drum_iirSampleFL = 0.0;
-    double drum_iirSampleGL = 0.0;
-    double drum_iirSampleHL = 0.0;
-    double drum_lastSampleL = 0.0;
-
-    double drum_iirSampleAR = 0.0;
-    double drum_iirSampleBR = 0.0;
-    double drum_iirSampleCR = 0.0;
-    double drum_iirSampleDR = 0.0;
-    double drum_iirSampleER = 0.0;
-    double drum_iirSampleFR = 0.0;
-    double drum_iirSampleGR = 0.0;
-    double drum_iirSampleHR = 0.0;
-    double drum_lastSampleR = 0.0;
-    bool drum_fpFlip = true;
-
-    // --- TPDF dither state ---
-    uint32_t fpdL = 1, fpdR = 1;
+    // Shared body of both processBlock() overloads
+    template <typename Sample>
+    void processAudio(juce::AudioBuffer<Sample>& buffer);
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+
+    // Raw parameter values, looked up once and indexed by SlamityDSP::ParamId
+    std::array<std::atomic<float>*, SlamityDSP::numParameters> paramValues {};
+
+    // Oversampling choice (0 = 1x, 1 = 2x, 2 = 4x). Not a SlamityDSP::ParamId:
+    // it changes the latency, so it is polled once per block instead.
+    std::atomic<float>* oversamplingValue = nullptr;
+    int getOversamplingFactor() const;
+
+    // Bit i is set when parameter i changed since the audio thread last read it
+    std::atomic<uint32_t> dirtyParams { 0 };
+
+    // Complete parameter sets from setStateInformation() and program changes,
+    // so they land on the audio thread in one piece rather than one parameter
+    // at a time
+    SlamityMailbox<SlamityDSP::Parameters> pendingParams;
+
+    SlamityDSP::Parameters getCurrentParameters() const;
+    void setHostParameters(const SlamityDSP::Parameters& set, bool userEdit);
+
+    // Host updates for the morph, throttled: the first move goes out at
+    // once, later ones from timerCallback() while they keep coming. A
+    // restore or program change drops an update still pending, so it can't
+    // move the parameters back.
+    static constexpr int morphHostRateHz = 30;
+    std::atomic<bool> morphHostPending { false };
+    bool sendingMorph = false;              // message thread
+    void sendMorphToHost();
+    void timerCallback() override;
+
+    SlamityPresetBank presets;
+    std::atomic<int> currentProgram { 0 };
+
+    // Set by a restore, cleared by any parameter move or program call, so
+    // only a re-select straight after the restore is ignored
+    std::atomic<bool> restoredUntouched { false };
+
+    // A/B snapshots: the message thread's copy, and the audio thread's, which
+    // it takes from the mailbox before computing a morph
+    using SnapshotPair = std::array<SlamityDSP::Parameters, 2>;
+    SnapshotPair snapshots;
+    SnapshotPair audioSnapshots;
+    SlamityMailbox<SnapshotPair> pendingSnapshots;
+
+    std::atomic<float> morphAmount { 0.0f };
+    float appliedMorph = 0.0f;              // audio thread
+
+    // JUCE-free Mackity + DrumSlam core; this class only adapts it to the host
+    SlamityDSP dsp;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlamityProcessor)
 };
@@ -0,0 +1,180 @@
+#include "SlamityAssets.h"
+#include <BinaryData.h>
+
+namespace
+{
+    struct EmbeddedImage { const char* data; int size; };
+
+    // In SlamityAssets::Id order
+    const EmbeddedImage embeddedImages[SlamityAssets::numAssets] = {
+        { BinaryData::GUI_BG_NoLabellogo_png, BinaryData::GUI_BG_NoLabellogo_pngSize },
+        { BinaryData::Rotary_png,             BinaryData::Rotary_pngSize },
+        { BinaryData::Switch_png,             BinaryData::Switch_pngSize },
+        { BinaryData::VU_png,                 BinaryData::VU_pngSize }
+    };
+
+    // The one live store, if any editor holds it
+    SlamityAssets* instance = nullptr;
+}
+
+//==============================================================================
+// RotaryFilmstrip implementation
+//==============================================================================
+void RotaryFilmstrip::draw(juce::Graphics& g, const juce::Image& image, juce::Rectangle<int> area,
+                           juce::Point<int> componentOrigin, float sliderPos, float startAngle, float endAngle)
+{
+    if (! image.isValid()) return;
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const float side = (float)juce::jmin(area.getWidth(), area.getHeight());
+    const int size = juce::roundToInt(side * scale);
+    if (size <= 0) return;
+
+    auto set = std::find_if(sets.begin(), sets.end(), [&](const FrameSet& s) {
+        return s.size == size && s.startAngle == startAngle && s.endAngle == endAngle;
+    });
+
+    if (set == sets.end())
+    {
+        if ((int)sets.size() == maxSets)
+            sets.erase(sets.begin());
+
+        sets.push_back({ size, startAngle, endAngle, std::vector<juce::Image>((size_t)numSteps + 1) });
+        set = sets.end() - 1;
+    }
+
+    const int step = juce::jlimit(0, numSteps, juce::roundToInt(sliderPos * (float)numSteps));
+    auto& frame = set->frames[(size_t)step];
+    if (! frame.isValid())
+        frame = renderFrame(image, size, startAngle + (float)step / (float)numSteps * (endAngle - startAngle));
+
+    // Centred in the area, one frame pixel per physical pixel, with the
+    // top-left rounded to a whole physical pixel so the frame is blitted
+    // rather than resampled
+    const auto origin = componentOrigin.toFloat();
+    const auto topLeft = area.toFloat().getCentre() - juce::Point<float>(side * 0.5f, side * 0.5f);
+    const auto physical = ((topLeft + origin) * scale).roundToInt().toFloat();
+    const auto snapped = physical / scale - origin;
+
+    g.drawImageTransformed(frame, juce::AffineTransform::scale(1.0f / scale).translated(snapped.x, snapped.y));
+}
+
+juce::Image RotaryFilmstrip::renderFrame(const juce::Image& image, int size, float angle)
+{
+    juce::Image frame(juce::Image::ARGB, size, size, true);
+    juce::Graphics g(frame);
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+
+    // Scale image to fit the frame, rotated about its centre
+    const float scale = (float)size / (float)image.getWidth();
+    const float imgCx = image.getWidth()  * 0.5f;
+    const float imgCy = image.getHeight() * 0.5f;
+    const float half = (float)size * 0.5f;
+
+    g.drawImageTransformed(image, juce::AffineTransform::rotation(angle, imgCx, imgCy)
+                                      .scaled(scale)
+                                      .translated(half - imgCx * scale, half - imgCy * scale));
+    return frame;
+}
+
+//==============================================================================
+// SlamityAssets implementation
+//==============================================================================
+SlamityAssets::Ptr SlamityAssets::getInstance()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (instance == nullptr)
+        instance = new SlamityAssets();
+    return instance;
+}
+
+class SlamityAssets::DecodeJob : public juce::ThreadPoolJob
+{
+public:
+    explicit DecodeJob(SlamityAssets& owner) : juce::ThreadPoolJob("SlamityAssets decoder"), assets(owner) {}
+
+    JobStatus runJob() override
+    {
+        for (int i = 0; i < numAssets; ++i)
+        {
+            if (shouldExit()) return jobHasFinished;
+
+            assets.images[i] = juce::ImageFileFormat::loadFrom(embeddedImages[i].data, (size_t)embeddedImages[i].size);
+            assets.decoded[i].store(true, std::memory_order_release);
+        }
+
+        // Safe from this thread: ChangeBroadcaster only posts an async
+        // message, delivered later on the message thread, and the store's
+        // destructor (which cancels it) waits for this job first
+        assets.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+private:
+    SlamityAssets& assets;
+};
+
+SlamityAssets::SlamityAssets()
+{
+    decoder.addJob(new DecodeJob(*this), true);
+}
+
+SlamityAssets::~SlamityAssets()
+{
+    // The job stops at the next image once asked, so waiting for it is
+    // bounded by one decode; it must not outlive the images it writes
+    decoder.removeAllJobs(true, -1);
+    instance = nullptr;
+}
+
+juce::Rectangle<int> SlamityAssets::getNativeBounds(Id id) const
+{
+    // Width and height from the PNG header (big-endian, in the IHDR chunk)
+    const auto* bytes = reinterpret_cast<const uint8_t*>(embeddedImages[id].data);
+    if (embeddedImages[id].size < 24) return {};
+
+    const auto readBigEndian = [bytes](int offset) {
+        return (int)(((uint32_t)bytes[offset] << 24) | ((uint32_t)bytes[offset + 1] << 16)
+                     | ((uint32_t)bytes[offset + 2] << 8) | (uint32_t)bytes[offset + 3]);
+    };
+    return { readBigEndian(16), readBigEndian(20) };
+}
+
+juce::Image SlamityAssets::getImage(Id id) const
+{
+    return decoded[id].load(std::memory_order_acquire) ? images[id] : juce::Image();
+}
+
+juce::Image SlamityAssets::getScaled(Id id, int width, int height)
+{
+    for (const auto& s : scaled)
+        if (s.id == id && s.image.getWidth() == width && s.image.getHeight() == height)
+            return s.image;
+
+    const auto image = getImage(id);
+    if (! image.isValid() || width <= 0 || height <= 0)
+        return {};
+
+    juce::Image result(image.getFormat(), width, height, true);
+    {
+        juce::Graphics g(result);
+        g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+        g.drawImage(image, result.getBounds().toFloat());
+    }
+
+    // Drop this image's oldest copy once it has too many
+    const auto count = std::count_if(scaled.begin(), scaled.end(), [id](const ScaledImage& s) { return s.id == id; });
+    if (count >= maxScaledPerImage)
+        scaled.erase(std::find_if(scaled.begin(), scaled.end(), [id](const ScaledImage& s) { return s.id == id; }));
+
+    scaled.push_back({ id, result });
+    return result;
+}
+
+void SlamityAssets::drawRotary(Id id, juce::Graphics& g, juce::Rectangle<int> area, const juce::Component& component,
+                               float sliderPos, float startAngle, float endAngle)
+{
+    const auto* topLevel = component.getTopLevelComponent();
+    const auto origin = topLevel->getLocalPoint(&component, juce::Point<int>());
+    filmstrips[id].draw(g, getImage(id), area, origin, sliderPos, startAngle, endAngle);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//==============================================================================
+// Rotation filmstrip for an image-based rotary control. The image is rendered
+// at numSteps + 1 evenly spaced angles across the slider's rotary range, at
+// the size and display scale it is drawn at, so drawing a control is a plain
+// unscaled blit. Each frame is rendered the first time it is needed. A few
+// sets (sizes, scales or ranges) are kept at once, oldest dropped first.
+//
+// A blit needs the frame on whole physical pixels, which at display scales
+// such as 1.25 or 1.5 a logical position often isn't. So draw() also takes
+// where the control's component sits in its top-level component (logical
+// pixels, whose origin is on a physical pixel) and snaps the frame to the
+// nearest physical pixel from there.
+//==============================================================================
+class RotaryFilmstrip
+{
+public:
+    static constexpr int numSteps = 128;    // even, so 50% has a frame of its own
+    static constexpr int maxSets = 3;
+
+    // The image is rotated about its centre, 0 rad leaving it as drawn.
+    // componentOrigin is the drawing component's top-left in its top-level
+    // component.
+    void draw(juce::Graphics& g, const juce::Image& image, juce::Rectangle<int> area,
+              juce::Point<int> componentOrigin, float sliderPos, float startAngle, float endAngle);
+
+private:
+    struct FrameSet
+    {
+        int size = 0;                       // physical pixels
+        float startAngle = 0.0f, endAngle = 0.0f;
+        std::vector<juce::Image> frames;    // numSteps + 1, empty until rendered
+    };
+
+    std::vector<FrameSet> sets;             // most recently created last
+
+    static juce::Image renderFrame(const juce::Image& image, int size, float angle);
+};
+
+//==============================================================================
+// The editor's images, shared by every editor in the process.
+//
+// The first editor to open creates the store, which starts decoding the
+// embedded PNGs on a background thread; until an image is ready getImage()
+// returns an invalid one and the store broadcasts a change once they all
+// are. Scaled copies and knob filmstrips are made on first use and shared
+// too, a bounded number per image. Everything is released when the last
+// editor lets go of its reference. Message thread only.
+//==============================================================================
+class SlamityAssets : public juce::ReferenceCountedObject,
+                      public juce::ChangeBroadcaster
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<SlamityAssets>;
+
+    enum Id { background, rotary, rotarySwitch, vuMeter, numAssets };
+
+    static Ptr getInstance();
+    ~SlamityAssets() override;
+
+    // True once every image has decoded
+    bool isReady() const { return decoded[numAssets - 1].load(std::memory_order_acquire); }
+
+    // Pixel size of the embedded image, known before it is decoded
+    juce::Rectangle<int> getNativeBounds(Id id) const;
+
+    // The decoded image, or an invalid one while it is still decoding
+    juce::Image getImage(Id id) const;
+
+    // The image resampled to width x height pixels (at high quality)
+    juce::Image getScaled(Id id, int width, int height);
+
+    // Draws a rotary control from the image's shared filmstrip
+    void drawRotary(Id id, juce::Graphics& g, juce::Rectangle<int> area, const juce::Component& component,
+                    float sliderPos, float startAngle, float endAngle);
+
+private:
+    SlamityAssets();
+
+    juce::Image images[numAssets];
+    std::atomic<bool> decoded[numAssets] {};
+
+    // Decodes the images in Id order on the pool's thread, stopping early
+    // if the store is released first
+    class DecodeJob;
+    juce::ThreadPool decoder { juce::ThreadPoolOptions{}.withThreadName("SlamityAssets").withNumberOfThreads(1) };
+
+    struct ScaledImage
+    {
+        Id id;
+        juce::Image image;
+    };
+
+    static constexpr int maxScaledPerImage = 3;
+    std::vector<ScaledImage> scaled;        // most recently created last
+    RotaryFilmstrip filmstrips[numAssets];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlamityAssets)
+};
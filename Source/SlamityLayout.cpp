@@ -0,0 +1,57 @@
+#include "SlamityLayout.h"
+
+SlamityLayout::SlamityLayout()
+{
+    std::copy(std::begin(SlamityLayoutTable::values), std::end(SlamityLayoutTable::values), values.begin());
+
+   #if JUCE_DEBUG
+    // The compiled values may already be stale if the file was edited
+    // since the last build
+    lastModified = sourceFile.getLastModificationTime();
+    reload();
+    startTimer(500);
+   #endif
+}
+
+#if JUCE_DEBUG
+void SlamityLayout::timerCallback()
+{
+    // Only a stat per tick; the file is read only when it has been saved
+    const auto modified = sourceFile.getLastModificationTime();
+    if (modified == lastModified) return;
+
+    lastModified = modified;
+    if (reload() && onChange != nullptr)
+        onChange();
+}
+
+// Reads the file in the same "name = number" format the build compiles.
+// Unknown names are ignored: new entries need a rebuild to get a key.
+bool SlamityLayout::reload()
+{
+    if (! sourceFile.existsAsFile()) return false;
+
+    bool changed = false;
+    for (auto& line : juce::StringArray::fromLines(sourceFile.loadFileAsString()))
+    {
+        auto trimmed = line.trimStart();
+        if (trimmed.isEmpty() || trimmed[0] == '#') continue;
+        auto eq = trimmed.indexOfChar('=');
+        if (eq < 0) continue;
+
+        const auto name = trimmed.substring(0, eq).trim();
+        const float value = trimmed.substring(eq + 1).trim().getFloatValue();
+
+        for (int k = 0; k < SlamityLayoutTable::numKeys; ++k)
+        {
+            if (name == SlamityLayoutTable::names[k])
+            {
+                changed |= values[(size_t)k] != value;
+                values[(size_t)k] = value;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <SlamityLayoutTable.h>
+
+//==============================================================================
+// Editor layout values from GUI/layout.txt, compiled into a constant table at
+// build time (cmake/SlamityLayout.cmake) and indexed by key.
+//
+// Debug builds also watch the file while an editor is open and re-read it
+// when it is saved, so the layout can still be tuned live.
+//==============================================================================
+class SlamityLayout
+#if JUCE_DEBUG
+    : private juce::Timer
+#endif
+{
+public:
+    using Key = SlamityLayoutTable::Key;
+
+    SlamityLayout();
+
+    float operator[](Key key) const noexcept { return values[(size_t)key]; }
+
+    // Debug builds: called after layout.txt changed and was read back in
+    std::function<void()> onChange;
+
+private:
+    std::array<float, SlamityLayoutTable::numKeys> values;
+
+   #if JUCE_DEBUG
+    juce::File sourceFile { SlamityLayoutTable::sourceFile };
+    juce::Time lastModified;
+
+    void timerCallback() override;
+    bool reload();
+   #endif
+};
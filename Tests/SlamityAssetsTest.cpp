@@ -0,0 +1,76 @@
+#include "PluginEditor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+//==============================================================================
+// SlamityAssetsTest: an editor can be closed while the shared images are
+// still decoding.
+//
+// Opens and closes an editor repeatedly, so the last reference to the image
+// store goes away while its decode job is part way through. Each close must
+// stop the job and release the store, and a pending change message must not
+// reach it afterwards. An editor opened after that must get a fresh store
+// that finishes decoding. Exits non-zero on any failure.
+//==============================================================================
+
+namespace
+{
+    constexpr int numCycles = 20;
+    constexpr int readyTimeoutMs = 10000;
+
+    using Clock = std::chrono::steady_clock;
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    auto& messageManager = *juce::MessageManager::getInstance();
+
+    SlamityProcessor processor;
+    int failures = 0;
+    int closedWhileDecoding = 0;
+    double slowestCloseMs = 0.0;
+
+    for (int cycle = 0; cycle < numCycles; ++cycle)
+    {
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+        if (! SlamityAssets::getInstance()->isReady())
+            ++closedWhileDecoding;
+
+        const auto start = Clock::now();
+        editor.reset();
+        slowestCloseMs = std::max(slowestCloseMs,
+                                  std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        // Deliver anything the decoder posted before it stopped
+        messageManager.runDispatchLoopUntil(5);
+    }
+
+    std::printf("%s %d of %d editors closed while decoding, slowest close %.1f ms\n",
+                closedWhileDecoding > 0 ? "ok  " : "FAIL", closedWhileDecoding, numCycles, slowestCloseMs);
+    if (closedWhileDecoding == 0) ++failures;
+
+    // A fresh store after all that still decodes every image
+    {
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+        const auto assets = SlamityAssets::getInstance();
+
+        const auto start = Clock::now();
+        while (! assets->isReady()
+               && std::chrono::duration<double, std::milli>(Clock::now() - start).count() < readyTimeoutMs)
+            messageManager.runDispatchLoopUntil(5);
+
+        bool allDecoded = assets->isReady();
+        for (int id = 0; id < SlamityAssets::numAssets; ++id)
+            allDecoded &= assets->getImage((SlamityAssets::Id)id).isValid();
+
+        std::printf("%s an editor opened afterwards gets every image\n", allDecoded ? "ok  " : "FAIL");
+        if (! allDecoded) ++failures;
+    }
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
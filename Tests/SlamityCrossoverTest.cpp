@@ -0,0 +1,333 @@
+#include "SlamityDSP.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//==============================================================================
+// SlamityCrossoverTest: the DrumSlam crossover's two-stream form must stay
+// bit-identical to the original per-sample alternation between its filter
+// sets.
+//
+// The reference below is a scalar DrumSlam written the original way, with a
+// branch on fpFlip every sample, followed by the main gain and mix and the
+// kernel's metering. It renders the same input as SlamityDSP (double I/O,
+// precise maths, 1x, Mackity bypassed so only DrumSlam runs) over odd and
+// even block lengths, blocks of one sample and chunked blocks, and again
+// with the next filter set forced over partway through (the two sets hold
+// the same state straight after reset, so only a later switch shows which
+// one runs). Output samples and meter frames must match bit for bit.
+// Exits non-zero if they don't.
+//==============================================================================
+
+namespace
+{
+    constexpr int kernelChunkFrames = 256;     // SlamityDSP's scratch length
+
+    struct Case
+    {
+        const char* name;
+        int maxBlockSize;
+        std::vector<int> blocks;    // repeated until the input runs out
+    };
+
+    const Case cases[] = {
+        { "blocks of 1",        512, { 1 } },
+        { "blocks of 7",        512, { 7 } },
+        { "blocks of 64",       512, { 64 } },
+        { "blocks of 512",      512, { 512 } },
+        { "mixed lengths",      512, { 511, 1, 256, 3, 2, 257, 13 } },
+        { "short max, odd",     100, { 100, 37 } },
+        { "max block size 1",     1, { 1 } },
+    };
+
+    const double sampleRates[] = { 48000.0, 96000.0 };
+
+    SlamityDSP::Parameters drumOnly()
+    {
+        SlamityDSP::Parameters params;
+        params.mackDryWet = 0.0f;       // bypasses Mackity
+        params.drumDrive  = 0.8f;
+        params.drumOutput = 0.9f;
+        params.drumDryWet = 0.7f;
+        params.mainOutput = 0.95f;
+        params.mainDryWet = 0.85f;
+        return params;
+    }
+
+    // Noise-modulated drums, never quiet enough for the denormal guard
+    void fillInput(std::vector<double>& left, std::vector<double>& right)
+    {
+        uint32_t noise = 0x12345678;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+            const double env = std::exp(-(double)(i % 12000) / 2400.0);
+            const double n = (double)noise / 4294967296.0 - 0.5;
+            left[i]  = env * (0.9 * std::sin(0.0131 * (double)i) + 0.6 * n);
+            right[i] = env * (0.9 * std::sin(0.0127 * (double)i) - 0.6 * n);
+            for (double* x : { &left[i], &right[i] })
+                if (std::fabs(*x) < 1.0e-6) *x = 1.0e-6;
+        }
+    }
+
+    //==============================================================================
+    // DrumSlam as originally written, one sample and one channel at a time,
+    // in the kernel's order of operations
+    class ReferenceDrumSlam
+    {
+    public:
+        ReferenceDrumSlam(const SlamityDSP::Parameters& params, double sampleRate, int maxBlockSize)
+            : chunkFrames(std::min(maxBlockSize, kernelChunkFrames)),
+              meterPeriodSamples(std::max(1, (int)std::lround(SlamityDSP::meterPeriodSeconds * sampleRate)))
+        {
+            const double overallscale = 1.0 / 44100.0 * sampleRate;
+            amountL = 0.0819 / overallscale;
+            amountH = 0.377933067 / overallscale;
+
+            drive = (params.drumDrive * 3.0) + 1.0;
+            drumOut = params.drumOutput;
+            drumWet = params.drumDryWet;
+            mainOut = params.mainOutput;
+            mainWet = params.mainDryWet;
+        }
+
+        void process(double* const* channels, int numSamples)
+        {
+            for (int chunk = 0; chunk < numSamples; chunk += chunkFrames)
+            {
+                const int frames = std::min(chunkFrames, numSamples - chunk);
+                Totals totals;
+                totals.numSamples = frames;
+
+                double laneSums[numMeterPoints][2] = {};
+                double lanePeaks[numMeterPoints][2] = {};
+
+                for (int i = 0; i < frames; ++i)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        double& sample = channels[ch][chunk + i];
+                        Channel& c = state[ch];
+                        auto meter = [&](int point, double x) {
+                            laneSums[point][ch] += x * x;
+                            lanePeaks[point][ch] = std::max(lanePeaks[point][ch], std::fabs(x));
+                        };
+
+                        const double dry = sample;
+                        double x = dry * drive;
+                        meter(SlamityDSP::drumDriveMeter, x);
+
+                        // 3-band split, alternating filter sets every sample
+                        double low, mid;
+                        const double s = x;
+                        if (flip)
+                        {
+                            c.a = (c.a * (1.0 - amountL)) + (s * amountL);
+                            c.b = (c.b * (1.0 - amountL)) + (c.a * amountL);
+                            low = c.b;
+                            c.e = (c.e * (1.0 - amountH)) + (s * amountH);
+                            c.f = (c.f * (1.0 - amountH)) + (c.e * amountH);
+                            mid = c.f - c.b;
+                            x = s - c.f;
+                        }
+                        else
+                        {
+                            c.c = (c.c * (1.0 - amountL)) + (s * amountL);
+                            c.d = (c.d * (1.0 - amountL)) + (c.c * amountL);
+                            low = c.d;
+                            c.g = (c.g * (1.0 - amountH)) + (s * amountH);
+                            c.h = (c.h * (1.0 - amountH)) + (c.g * amountH);
+                            mid = c.h - c.d;
+                            x = s - c.h;
+                        }
+
+                        low = shapeBand(low, 0.448);
+                        x = shapeBand(x, 0.599);
+                        mid = shapeMid(mid, c.last);
+
+                        x = ((low + mid + x) / drive) * drumOut;
+                        meter(SlamityDSP::drumOutputMeter, x);
+                        x = (x * drumWet) + (dry * (1.0 - drumWet));
+
+                        x *= mainOut;
+                        x = (x * mainWet) + (dry * (1.0 - mainWet));
+                        meter(SlamityDSP::mainOutputMeter, x);
+                        sample = x;
+                    }
+                    flip = ! flip;
+                }
+
+                for (int m = 0; m < numMeterPoints; ++m)
+                {
+                    double sum = 0.0;
+                    for (int l = 0; l < 2; ++l)
+                    {
+                        sum += laneSums[m][l];
+                        totals.peak[m] = std::max(totals.peak[m], (float)lanePeaks[m][l]);
+                    }
+                    totals.sumSquares[m] += sum * 1.0;
+                }
+                addTotals(totals);
+            }
+        }
+
+        void switchFilterSet() { flip = ! flip; }
+
+        std::vector<SlamityDSP::MeterFrame> meterFrames;
+
+    private:
+        static constexpr int numMeterPoints = SlamityDSP::numMeterPoints;
+
+        struct Channel { double a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0, last = 0; };
+        struct Totals
+        {
+            double sumSquares[numMeterPoints] = {};
+            float peak[numMeterPoints] = {};
+            int numSamples = 0;
+        };
+
+        Channel state[2];
+        bool flip = true;
+        int chunkFrames, meterPeriodSamples;
+        double amountL, amountH, drive, drumOut, drumWet, mainOut, mainWet;
+        Totals period;
+
+        double shapeBand(double band, double bandShape) const
+        {
+            double s = std::max(std::min(band, 1.0), -1.0);
+            const double shape = std::fabs(s) * bandShape;
+            s -= s * shape * shape;
+            return s * drive;
+        }
+
+        double shapeMid(double mid, double& last) const
+        {
+            const double pi = 3.1415926, halfPi = 1.57079633;
+            const double midSample = mid * drive;
+
+            double skew = midSample - last;
+            last = midSample;
+            double bridgerectifier = std::sin(std::min(std::fabs(skew), pi));
+            bridgerectifier = bridgerectifier * pi;
+            skew = skew > 0.0 ? bridgerectifier : -bridgerectifier;
+            skew *= midSample;
+            skew *= 1.557079633;
+            bridgerectifier = std::fabs(midSample);
+            bridgerectifier += skew;
+            bridgerectifier = std::sin(std::min(bridgerectifier, halfPi));
+            bridgerectifier *= drive;
+            bridgerectifier += skew;
+            bridgerectifier = std::sin(std::min(bridgerectifier, halfPi));
+            return midSample > 0.0 ? bridgerectifier : -bridgerectifier;
+        }
+
+        void addTotals(const Totals& totals)
+        {
+            for (int m = 0; m < numMeterPoints; ++m)
+            {
+                period.sumSquares[m] += totals.sumSquares[m];
+                period.peak[m] = std::max(period.peak[m], totals.peak[m]);
+            }
+            period.numSamples += totals.numSamples;
+            if (period.numSamples < meterPeriodSamples) return;
+
+            SlamityDSP::MeterFrame frame;
+            const double invN = 1.0 / ((double)period.numSamples * 2.0);
+            for (int m = 0; m < numMeterPoints; ++m)
+            {
+                frame.rms[m] = (float)std::sqrt(period.sumSquares[m] * invN);
+                frame.peak[m] = period.peak[m];
+                if (frame.peak[m] >= 1.0f) frame.clipped |= 1u << m;
+            }
+            frame.numSamples = period.numSamples;
+            meterFrames.push_back(frame);
+            period = {};
+        }
+    };
+
+    //==============================================================================
+    bool sameFrame(const SlamityDSP::MeterFrame& a, const SlamityDSP::MeterFrame& b)
+    {
+        return std::memcmp(a.rms, b.rms, sizeof(a.rms)) == 0
+            && std::memcmp(a.peak, b.peak, sizeof(a.peak)) == 0
+            && a.clipped == b.clipped && a.numSamples == b.numSamples;
+    }
+
+    bool runCase(const Case& c, double sampleRate, bool switchSets, const std::vector<double>& inL,
+                 const std::vector<double>& inR)
+    {
+        const auto params = drumOnly();
+
+        SlamityDSP::MeterRing meters;
+        SlamityDSP dsp;
+        dsp.setParameters(params);
+        dsp.prepare(sampleRate, c.maxBlockSize);
+        dsp.setMeterOutput(&meters);
+
+        ReferenceDrumSlam reference(params, sampleRate, c.maxBlockSize);
+
+        std::vector<double> left(inL), right(inR), refLeft(inL), refRight(inR);
+        std::vector<SlamityDSP::MeterFrame> frames;
+        const int numSamples = (int)left.size();
+        bool switched = ! switchSets;
+
+        for (int pos = 0, b = 0; pos < numSamples; ++b)
+        {
+            if (! switched && pos >= numSamples / 3)
+            {
+                auto snapshot = dsp.getState();
+                snapshot.drumSlam.fpFlip = ! snapshot.drumSlam.fpFlip;
+                dsp.setState(snapshot);
+                reference.switchFilterSet();
+                switched = true;
+            }
+
+            const int n = std::min(c.blocks[(size_t)b % c.blocks.size()], numSamples - pos);
+            double* channels[] = { left.data() + pos, right.data() + pos };
+            double* refChannels[] = { refLeft.data() + pos, refRight.data() + pos };
+            dsp.process(channels, n);
+            reference.process(refChannels, n);
+            pos += n;
+
+            SlamityDSP::MeterFrame frame;
+            while (meters.pop(frame)) frames.push_back(frame);
+        }
+
+        const bool outputMatches = std::memcmp(left.data(), refLeft.data(), left.size() * sizeof(double)) == 0
+                                && std::memcmp(right.data(), refRight.data(), right.size() * sizeof(double)) == 0;
+
+        bool metersMatch = frames.size() == reference.meterFrames.size();
+        for (size_t i = 0; metersMatch && i < frames.size(); ++i)
+            metersMatch = sameFrame(frames[i], reference.meterFrames[i]);
+
+        const bool ok = outputMatches && metersMatch;
+        std::printf("%s %6.0f Hz, %s%s: output %s, %d meter frames %s\n",
+                    ok ? "ok  " : "FAIL", sampleRate, c.name, switchSets ? ", filter set switched" : "",
+                    outputMatches ? "identical" : "DIFFERS", (int)frames.size(),
+                    metersMatch ? "identical" : "DIFFER");
+        return ok;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    for (double sampleRate : sampleRates)
+    {
+        std::vector<double> inL((size_t)(sampleRate * 0.5)), inR(inL.size());
+        fillInput(inL, inR);
+
+        for (const auto& c : cases)
+            for (bool switchSets : { false, true })
+                if (! runCase(c, sampleRate, switchSets, inL, inR))
+                    ++failures;
+    }
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include "SlamityDSP.h"
+#include "SlamityFastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+// SlamityFastMathTest: holds FastMath to the error bounds documented in
+// SlamityFastMath.h.
+//
+//  - shaperSin against std::sin: 1.4e-11 absolute, over the DrumSlam range
+//    densely and up to |x| < 1e6 sparsely.
+//  - End to end, FastMath against PreciseMath output: 3e-8 per sample with
+//    double I/O; with float I/O, the same or the neighbouring float. At
+//    44.1-192 kHz, both chain orders, 1x / 2x / 4x, at full drive and trim
+//    and with every mix part way.
+//
+// Exits non-zero if either bound is exceeded.
+//==============================================================================
+
+namespace
+{
+    constexpr double sinBound = 1.4e-11;
+    constexpr double outputBound = 3.0e-8;
+
+    const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const int factors[] = { 1, 2, 4 };
+    constexpr int blockSize = 512;
+
+    double sinError(double x)
+    {
+        alignas(16) double lanes[2];
+        FastMath::shaperSin(Vec2d::broadcast(x)).store(lanes);
+        return std::fabs(lanes[0] - std::sin(x));
+    }
+
+    double maxSinError()
+    {
+        double worst = 0.0;
+
+        // Every argument the mid-band shaper can see is within a few hundred
+        for (double x = -400.0; x <= 400.0; x += 1.0e-4)
+            worst = std::max(worst, sinError(x));
+
+        uint32_t noise = 0x9e3779b9;
+        for (int i = 0; i < 1000000; ++i)
+        {
+            noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+            worst = std::max(worst, sinError(((double)noise / 4294967296.0 - 0.5) * 2.0e6));
+        }
+        return worst;
+    }
+
+    // Noise-modulated drums, loud enough to drive every clamp
+    void fillInput(std::vector<float>& left, std::vector<float>& right)
+    {
+        uint32_t noise = 0x12345678;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            noise ^= noise << 13; noise ^= noise >> 17; noise ^= noise << 5;
+            const double env = std::exp(-(double)(i % 12000) / 2400.0);
+            const double n = (double)noise / 4294967296.0 - 0.5;
+            left[i]  = (float)(env * (0.9 * std::sin(0.0131 * (double)i) + 0.6 * n));
+            right[i] = (float)(env * (0.9 * std::sin(0.0127 * (double)i) - 0.6 * n));
+        }
+    }
+
+    template <typename Sample>
+    std::vector<Sample> render(SlamityDSP::MathMode mode, const SlamityDSP::Parameters& params,
+                               double sampleRate, int factor, const std::vector<float>& inL,
+                               const std::vector<float>& inR)
+    {
+        // Same dither generators for both modes (they are seeded from rand())
+        std::srand(1);
+
+        SlamityDSP dsp;
+        dsp.setParameters(params);
+        dsp.prepare(sampleRate, blockSize);
+        dsp.setOversamplingFactor(factor);
+        dsp.setMathMode(mode);
+
+        std::vector<Sample> left(inL.begin(), inL.end()), right(inR.begin(), inR.end());
+        for (size_t pos = 0; pos < left.size(); pos += blockSize)
+        {
+            Sample* channels[] = { left.data() + pos, right.data() + pos };
+            dsp.process(channels, (int)std::min((size_t)blockSize, left.size() - pos));
+        }
+
+        left.insert(left.end(), right.begin(), right.end());
+        return left;
+    }
+
+    // Largest difference between the two renders. For float output, a
+    // difference of up to one ulp of the precise sample (the neighbouring
+    // float, when the two results round either side of a float) counts as
+    // within the bound.
+    template <typename Sample>
+    double maxDifference(const std::vector<Sample>& precise, const std::vector<Sample>& fast)
+    {
+        double worst = 0.0;
+        for (size_t i = 0; i < precise.size(); ++i)
+        {
+            double difference = std::fabs((double)fast[i] - (double)precise[i]);
+            if constexpr (std::is_same_v<Sample, float>)
+                if (fast[i] == std::nextafter(precise[i], fast[i]))
+                    difference = std::min(difference, outputBound);
+            worst = std::max(worst, difference);
+        }
+        return worst;
+    }
+
+    template <typename Sample>
+    bool checkOutput(const char* format, const SlamityDSP::Parameters& params, double sampleRate,
+                     int factor, const std::vector<float>& inL, const std::vector<float>& inR)
+    {
+        const auto precise = render<Sample>(SlamityDSP::MathMode::precise, params, sampleRate, factor, inL, inR);
+        const auto fast = render<Sample>(SlamityDSP::MathMode::fast, params, sampleRate, factor, inL, inR);
+        const double worst = maxDifference(precise, fast);
+        const bool ok = worst <= outputBound;
+
+        std::printf("%s %-6s %6.0f Hz %dx %s %s: max difference %.3g\n", ok ? "ok  " : "FAIL", format,
+                    sampleRate, factor, params.chainOrder < 0.5f ? "M>D" : "D>M",
+                    params.drumDrive == 1.0f ? "full drive" : "part mixes", worst);
+        return ok;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    const double sinWorst = maxSinError();
+    std::printf("shaperSin: max error %.3g (bound %.3g)\n", sinWorst, sinBound);
+    if (sinWorst > sinBound) ++failures;
+
+    SlamityDSP::Parameters fullDrive;
+    fullDrive.mackInTrim = 1.0f;
+    fullDrive.drumDrive  = 1.0f;
+
+    SlamityDSP::Parameters partMixes;
+    partMixes.mackInTrim = 0.3f;
+    partMixes.mackOutPad = 0.7f;
+    partMixes.mackDryWet = 0.6f;
+    partMixes.drumDrive  = 0.7f;
+    partMixes.drumOutput = 0.8f;
+    partMixes.drumDryWet = 0.5f;
+    partMixes.mainOutput = 0.9f;
+    partMixes.mainDryWet = 0.7f;
+
+    for (double sampleRate : sampleRates)
+    {
+        std::vector<float> inL((size_t)(sampleRate * 0.25)), inR(inL.size());
+        fillInput(inL, inR);
+
+        for (int factor : factors)
+        {
+            for (float chainOrder : { 0.0f, 1.0f })
+            {
+                for (auto params : { fullDrive, partMixes })
+                {
+                    params.chainOrder = chainOrder;
+                    if (! checkOutput<double>("double", params, sampleRate, factor, inL, inR)) ++failures;
+                    if (! checkOutput<float>("float", params, sampleRate, factor, inL, inR)) ++failures;
+                }
+            }
+        }
+    }
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include "PluginProcessor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//==============================================================================
+// SlamityMorphTest: a dragged morph is never overwritten by an older host
+// value.
+//
+// Drags the morph from A to B one step per block while the message loop
+// runs now and then, so the throttled host updates go out part way through
+// the drag and the morph moves on past them before the next block. The
+// processor's output (double I/O, so no dither) must stay bit-identical to
+// a bare SlamityDSP that is only ever handed the morph sets, during the
+// drag and after it. Once the drag settles, the host parameters must show
+// B. Exits non-zero on any failure.
+//==============================================================================
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64;
+    constexpr int numDragBlocks = 240;
+    constexpr int blocksPerMessageLoop = 4;
+
+    // In SlamityDSP::ParamId order, as the processor registers them
+    const char* const parameterIDs[SlamityDSP::numParameters] = {
+        "mackInTrim", "mackOutPad", "mackDryWet",
+        "drumDrive",  "drumOutput", "drumDryWet",
+        "chainOrder", "mainOutput", "mainDryWet"
+    };
+
+    SlamityDSP::Parameters currentParameters(SlamityProcessor& processor)
+    {
+        SlamityDSP::Parameters set;
+        for (int i = 0; i < SlamityDSP::numParameters; ++i)
+            set[(SlamityDSP::ParamId)i] = processor.apvts.getRawParameterValue(parameterIDs[i])->load();
+        return set;
+    }
+
+    void setHostValues(SlamityProcessor& processor, bool defaults)
+    {
+        for (int i = 0; i < SlamityDSP::numParameters; ++i)
+        {
+            auto* param = processor.apvts.getParameter(parameterIDs[i]);
+            param->setValueNotifyingHost(defaults ? param->getDefaultValue() : 0.15f + 0.09f * (float)i);
+        }
+    }
+
+    struct Renderer
+    {
+        SlamityProcessor& processor;
+        SlamityDSP reference;
+        juce::AudioBuffer<double> buffer { 2, blockSize };
+        std::vector<double> left = std::vector<double>(blockSize), right = std::vector<double>(blockSize);
+        juce::MidiBuffer midi;
+        juce::Random noise { 1234 };
+
+        // One block through both; true if the outputs match bit for bit
+        bool processBlock()
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                left[(size_t)i] = noise.nextDouble() - 0.5;
+                right[(size_t)i] = noise.nextDouble() - 0.5;
+                buffer.setSample(0, i, left[(size_t)i]);
+                buffer.setSample(1, i, right[(size_t)i]);
+            }
+
+            processor.processBlock(buffer, midi);
+            {
+                juce::ScopedNoDenormals noDenormals;
+                double* channels[] = { left.data(), right.data() };
+                reference.process(channels, blockSize);
+            }
+
+            return std::memcmp(buffer.getReadPointer(0), left.data(), sizeof(double) * blockSize) == 0
+                && std::memcmp(buffer.getReadPointer(1), right.data(), sizeof(double) * blockSize) == 0;
+        }
+    };
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    auto& messageManager = *juce::MessageManager::getInstance();
+
+    SlamityProcessor processor;
+
+    setHostValues(processor, false);
+    processor.storeSnapshot(SlamityProcessor::Snapshot::b);
+    const auto b = currentParameters(processor);
+
+    setHostValues(processor, true);
+    processor.storeSnapshot(SlamityProcessor::Snapshot::a);
+    const auto a = currentParameters(processor);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    Renderer renderer { processor };
+    renderer.reference.setParameters(a);
+    renderer.reference.prepare(sampleRate, blockSize, 2);
+    renderer.reference.setOversamplingFactor(1);
+
+    int failures = 0;
+    int firstMismatch = -1;
+    float appliedMorph = 0.0f;
+
+    for (int k = 1; k <= numDragBlocks; ++k)
+    {
+        // Host updates go out here, for the morph as it was...
+        if (k % blocksPerMessageLoop == 0)
+            messageManager.runDispatchLoopUntil(40);
+
+        // ...then it moves on before the next block
+        const float morph = (float)k / (float)numDragBlocks;
+        processor.setMorph(morph);
+        if (morph != appliedMorph)
+        {
+            appliedMorph = morph;
+            renderer.reference.setParameters(SlamityPresetBank::morph(a, b, morph));
+        }
+
+        if (! renderer.processBlock() && firstMismatch < 0)
+            firstMismatch = k;
+    }
+
+    std::printf("%s output follows the dragged morph bit for bit",
+                firstMismatch < 0 ? "ok  " : "FAIL");
+    if (firstMismatch >= 0) std::printf(" (first difference in block %d)", firstMismatch);
+    std::printf("\n");
+    if (firstMismatch >= 0) ++failures;
+
+    // Let the last throttled update go out and the timer stop
+    messageManager.runDispatchLoopUntil(200);
+
+    bool hostAtB = true;
+    for (int i = 0; i < SlamityDSP::numParameters; ++i)
+    {
+        auto* param = processor.apvts.getParameter(parameterIDs[i]);
+        hostAtB &= param->getValue() == param->convertTo0to1(b[(SlamityDSP::ParamId)i]);
+    }
+    std::printf("%s host parameters show B once the drag settles\n", hostAtB ? "ok  " : "FAIL");
+    if (! hostAtB) ++failures;
+
+    bool settled = true;
+    for (int k = 0; k < 32; ++k)
+        settled &= renderer.processBlock();
+    std::printf("%s output stays on B after the last host update\n", settled ? "ok  " : "FAIL");
+    if (! settled) ++failures;
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#include "SlamityOnePole.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//==============================================================================
+// SlamityOnePoleTest: holds the four-samples-per-step one-pole to the bound
+// documented in SlamityOnePole.h, 2 * eps * max|x| / a against the serial
+// recurrence (eps = 2^-53).
+//
+// Every one-pole the kernel builds (Mackity's two DC / subsonic blockers,
+// with their denormal flush, and the DrumSlam crossover's two) at 44.1-192
+// kHz times 1x / 2x / 4x, down to the smallest coefficient in use (Mackity's
+// subsonic blocker at 4x 192 kHz, a = 1.65e-5). Lowpass and highpass, over
+// full-scale noise, noise on a stepped DC offset and a slow square wave, in
+// blocks of irregular length so the serial tail and the state handoff
+// between calls are covered too. Exits non-zero if the bound is exceeded.
+//==============================================================================
+
+namespace
+{
+    constexpr double eps = 1.1102230246251565e-16;     // 2^-53
+
+    const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const int factors[] = { 1, 2, 4 };
+
+    // As SlamityDSP computes them, at 44.1 kHz
+    struct Filter { const char* name; double amountAt44k; double flushBelow; };
+    const Filter filters[] = {
+        { "mack DC blocker A",  0.001860867, 1.18e-37 },
+        { "mack DC blocker B",  0.000287496, 1.18e-37 },
+        { "drum split L",       0.0819,      0.0 },
+        { "drum split H",       0.377933067, 0.0 },
+    };
+
+    enum Signal { noise, steppedDC, square, numSignals };
+    const char* const signalNames[numSignals] = { "noise", "stepped DC", "square" };
+
+    // Two channels, one second at the given rate; returns max|x|
+    double fillInput(Signal signal, double rate, std::vector<double>& left, std::vector<double>& right)
+    {
+        left.resize((size_t)rate);
+        right.resize(left.size());
+
+        uint32_t state = 0x2545f491;
+        auto next = [&state] {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            return (double)state / 4294967296.0 * 2.0 - 1.0;
+        };
+
+        double peak = 0.0;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            const double t = (double)i / rate;
+            switch (signal)
+            {
+                case noise:
+                    left[i] = next();
+                    right[i] = next();
+                    break;
+                case steppedDC:
+                {
+                    const double offset = ((int)(t * 4.0) & 1) ? -0.5 : 0.5;
+                    left[i] = offset + 0.5 * next();
+                    right[i] = -offset + 0.5 * next();
+                    break;
+                }
+                case square:
+                    left[i] = std::fmod(t * 20.0, 1.0) < 0.5 ? 1.0 : -1.0;
+                    right[i] = std::fmod(t * 3.0, 1.0) < 0.5 ? 0.9 : -0.9;
+                    break;
+                default:
+                    break;
+            }
+            peak = std::max({ peak, std::fabs(left[i]), std::fabs(right[i]) });
+        }
+        return peak;
+    }
+
+    // The serial form, exactly as the kernel runs it in PreciseMath
+    void serial(const std::vector<double>& in, std::vector<double>& out, double a, double flushBelow, bool highpass)
+    {
+        double y = 0.0;
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            if (std::fabs(y) < flushBelow) y = 0.0;
+            y = (y * (1.0 - a)) + (in[i] * a);
+            out[i] = highpass ? in[i] - y : y;
+        }
+    }
+
+    // The block form over both channels at once, in blocks of irregular length
+    void block(const std::vector<double>& left, const std::vector<double>& right,
+               std::vector<double>& outLeft, std::vector<double>& outRight,
+               double a, double flushBelow, bool highpass)
+    {
+        const SlamityOnePole<Vec2d> filter(a, flushBelow);
+        Vec2d y = Vec2d::broadcast(0.0);
+
+        std::vector<Vec2d> buffer(301);
+        uint32_t lengths = 0x9e3779b9;
+        alignas(16) double lanes[2];
+
+        for (size_t pos = 0; pos < left.size();)
+        {
+            lengths ^= lengths << 13; lengths ^= lengths >> 17; lengths ^= lengths << 5;
+            const int n = (int)std::min<size_t>(1 + lengths % 300, left.size() - pos);
+
+            for (int j = 0; j < n; ++j)
+                buffer[(size_t)j] = Vec2d::fromLanes(left[pos + (size_t)j], right[pos + (size_t)j]);
+
+            if (highpass)
+                filter.highpass(buffer.data(), buffer.data(), n, 1, y);
+            else
+                filter.lowpass(buffer.data(), buffer.data(), n, 1, y);
+
+            for (int j = 0; j < n; ++j)
+            {
+                buffer[(size_t)j].store(lanes);
+                outLeft[pos + (size_t)j] = lanes[0];
+                outRight[pos + (size_t)j] = lanes[1];
+            }
+            pos += (size_t)n;
+        }
+    }
+
+    double maxDifference(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        double worst = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+            worst = std::max(worst, std::fabs(a[i] - b[i]));
+        return worst;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+    double smallestAmount = 1.0;
+
+    std::vector<double> left, right, serialLeft, serialRight, blockLeft, blockRight;
+
+    for (double sampleRate : sampleRates)
+    {
+        for (int factor : factors)
+        {
+            const double rate = sampleRate * factor;
+            const double overallscale = 1.0 / 44100.0 * rate;
+
+            for (int s = 0; s < numSignals; ++s)
+            {
+                const double peak = fillInput((Signal)s, rate, left, right);
+                serialLeft.resize(left.size()); serialRight.resize(left.size());
+                blockLeft.resize(left.size()); blockRight.resize(left.size());
+
+                for (const auto& f : filters)
+                {
+                    const double a = f.amountAt44k / overallscale;
+                    smallestAmount = std::min(smallestAmount, a);
+                    const double bound = 2.0 * eps * peak / a;
+
+                    for (bool highpass : { false, true })
+                    {
+                        serial(left, serialLeft, a, f.flushBelow, highpass);
+                        serial(right, serialRight, a, f.flushBelow, highpass);
+                        block(left, right, blockLeft, blockRight, a, f.flushBelow, highpass);
+
+                        const double worst = std::max(maxDifference(serialLeft, blockLeft),
+                                                      maxDifference(serialRight, blockRight));
+                        const bool ok = worst <= bound;
+                        if (! ok) ++failures;
+
+                        std::printf("%s %6.0f Hz %dx %-17s a = %-9.3g %-8s %-10s: max difference %.3g (bound %.3g)\n",
+                                    ok ? "ok  " : "FAIL", sampleRate, factor, f.name, a,
+                                    highpass ? "highpass" : "lowpass", signalNames[s], worst, bound);
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("smallest coefficient tested: %.4g\n", smallestAmount);
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
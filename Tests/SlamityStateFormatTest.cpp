@@ -0,0 +1,181 @@
+#include "SlamityStateFormat.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// SlamityStateFormatTest: the binary state the plugin saves reads back as
+// written, and anything else is rejected without touching the values, so
+// the processor can fall back to the XML reader.
+//
+// Covers a round trip and the byte layout, every truncation of a blob, a
+// wrong magic, version 0, a later version with more or fewer values than
+// the reader knows, a count longer than the data, non-finite values, and a
+// legacy blob (the XML state older versions saved, in JUCE's
+// copyXmlToBinary() wrapping). Exits non-zero on any failure.
+//==============================================================================
+
+namespace
+{
+    constexpr int numValues = 10;       // SlamityProcessor's count
+    const float written[numValues] = { 0.1f, 1.0f, 0.6f, 0.45f, 0.85f, 1.0f, 1.0f, 0.9f, 0.4f, 2.0f };
+    constexpr float untouched = -7.0f;
+
+    int failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+        if (! ok) ++failures;
+    }
+
+    std::vector<uint8_t> blob(const float* values, int count)
+    {
+        std::vector<uint8_t> data(SlamityStateFormat::sizeFor(count));
+        SlamityStateFormat::write(values, count, data.data());
+        return data;
+    }
+
+    struct Readback
+    {
+        bool accepted;
+        float values[numValues];
+    };
+
+    Readback readBack(const std::vector<uint8_t>& data, size_t size)
+    {
+        Readback r;
+        for (float& v : r.values) v = untouched;
+        r.accepted = SlamityStateFormat::read(data.data(), size, r.values, numValues);
+        return r;
+    }
+
+    bool allUntouched(const Readback& r)
+    {
+        for (float v : r.values)
+            if (v != untouched) return false;
+        return true;
+    }
+
+    bool matches(const Readback& r, int first, int count)
+    {
+        for (int i = 0; i < numValues; ++i)
+        {
+            const bool expectWritten = i >= first && i < first + count;
+            if (expectWritten ? std::memcmp(&r.values[i], &written[i], 4) != 0 : r.values[i] != untouched)
+                return false;
+        }
+        return true;
+    }
+
+    // A legacy state: XML text wrapped as AudioProcessor::copyXmlToBinary()
+    // does (u32 magic "VC2!", u32 length, text, terminator)
+    std::vector<uint8_t> legacyXmlBlob()
+    {
+        const std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Parameters>"
+                                "<PARAM id=\"drumDrive\" value=\"0.5\"/></Parameters>";
+        std::vector<uint8_t> data;
+        const uint32_t header[2] = { 0x21324356, (uint32_t)xml.size() + 1 };
+        for (uint32_t word : header)
+            for (int b = 0; b < 4; ++b)
+                data.push_back((uint8_t)(word >> (8 * b)));
+        data.insert(data.end(), xml.begin(), xml.end());
+        data.push_back(0);
+        return data;
+    }
+}
+
+int main()
+{
+    // Round trip and layout
+    {
+        const auto data = blob(written, numValues);
+        check(data.size() == 8 + 4 * numValues, "size is header + 4 bytes per value");
+        check(std::memcmp(data.data(), "SLMY", 4) == 0 && data[4] == 1 && data[5] == 0
+                  && data[6] == numValues && data[7] == 0,
+              "header is \"SLMY\", version 1, count, little-endian");
+
+        const auto r = readBack(data, data.size());
+        check(r.accepted && matches(r, 0, numValues), "round trip restores every value bit for bit");
+    }
+
+    // Every truncation, down to nothing
+    {
+        const auto data = blob(written, numValues);
+        bool ok = true;
+        for (size_t size = 0; size < data.size(); ++size)
+        {
+            const auto r = readBack(data, size);
+            ok &= ! r.accepted && allUntouched(r);
+        }
+        check(ok, "every truncated blob is rejected and leaves the values alone");
+        check(! SlamityStateFormat::read(nullptr, 0, nullptr, 0), "no data is rejected");
+    }
+
+    // Header fields off
+    {
+        auto data = blob(written, numValues);
+        data[0] ^= 0xff;
+        const auto r = readBack(data, data.size());
+        check(! r.accepted && allUntouched(r), "wrong magic is rejected");
+    }
+    {
+        auto data = blob(written, numValues);
+        data[4] = 0;
+        const auto r = readBack(data, data.size());
+        check(! r.accepted && allUntouched(r), "version 0 is rejected");
+    }
+    {
+        auto data = blob(written, numValues);
+        data[6] = numValues + 1;
+        const auto r = readBack(data, data.size());
+        check(! r.accepted && allUntouched(r), "a count longer than the data is rejected");
+    }
+
+    // Later versions: more values, or fewer
+    {
+        float more[numValues + 3];
+        std::memcpy(more, written, sizeof(written));
+        more[numValues] = more[numValues + 1] = more[numValues + 2] = 3.0f;
+
+        auto data = blob(more, numValues + 3);
+        data[4] = 2;
+        const auto r = readBack(data, data.size());
+        check(r.accepted && matches(r, 0, numValues), "version 2 with extra values: known ones read, rest ignored");
+    }
+    {
+        auto data = blob(written, 4);
+        data[4] = 2;
+        const auto r = readBack(data, data.size());
+        check(r.accepted && matches(r, 0, 4), "fewer values than known: those read, the rest left alone");
+    }
+
+    // Non-finite values keep what was there
+    {
+        float values[numValues];
+        std::memcpy(values, written, sizeof(written));
+        values[2] = std::numeric_limits<float>::quiet_NaN();
+        values[5] = std::numeric_limits<float>::infinity();
+
+        const auto r = readBack(blob(values, numValues), SlamityStateFormat::sizeFor(numValues));
+        bool ok = r.accepted && r.values[2] == untouched && r.values[5] == untouched;
+        for (int i : { 0, 1, 3, 4, 6, 7, 8, 9 })
+            ok &= r.values[i] == written[i];
+        check(ok, "NaN and infinity are skipped");
+    }
+
+    // The legacy XML state goes to the fallback reader
+    {
+        const auto data = legacyXmlBlob();
+        const auto r = readBack(data, data.size());
+        check(! r.accepted && allUntouched(r), "legacy XML blob is rejected, for the XML fallback");
+    }
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
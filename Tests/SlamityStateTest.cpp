@@ -0,0 +1,167 @@
+#include "PluginProcessor.h"
+
+#include <cmath>
+#include <cstdio>
+
+//==============================================================================
+// SlamityStateTest: saving and restoring a processor's state.
+//
+// A state saved by getStateInformation() restores every parameter into a
+// fresh instance, and so does the XML state older versions saved. A
+// truncated blob, or one with a version or count the reader can't accept,
+// restores nothing. Restores and program changes move the parameters
+// without change gestures (hosts in touch or latch mode would record them
+// as edits); a morph, which the user makes, does use them. Re-selecting
+// the current program loads it again, except straight after a restore.
+// Exits non-zero on any failure.
+//==============================================================================
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+        if (! ok) ++failures;
+    }
+
+    // Every parameter off its default, each to a different value
+    void setDistinctValues(SlamityProcessor& processor)
+    {
+        const auto& params = processor.getParameters();
+        for (int i = 0; i < params.size(); ++i)
+            params[i]->setValueNotifyingHost(0.2f + 0.07f * (float)i);
+    }
+
+    bool sameValues(SlamityProcessor& a, SlamityProcessor& b)
+    {
+        const auto& pa = a.getParameters();
+        const auto& pb = b.getParameters();
+        for (int i = 0; i < pa.size(); ++i)
+            if (std::abs(pa[i]->getValue() - pb[i]->getValue()) > 1.0e-6f)
+                return false;
+        return true;
+    }
+
+    void restore(SlamityProcessor& processor, const juce::MemoryBlock& state, size_t size)
+    {
+        processor.setStateInformation(state.getData(), (int)size);
+    }
+
+    // Counts the change gestures begun on every parameter of a processor
+    struct GestureCounter : juce::AudioProcessorParameter::Listener
+    {
+        explicit GestureCounter(SlamityProcessor& p) : processor(p)
+        {
+            for (auto* param : processor.getParameters())
+                param->addListener(this);
+        }
+
+        ~GestureCounter() override
+        {
+            for (auto* param : processor.getParameters())
+                param->removeListener(this);
+        }
+
+        void parameterValueChanged(int, float) override { ++changes; }
+        void parameterGestureChanged(int, bool starting) override { if (starting) ++gestures; }
+
+        SlamityProcessor& processor;
+        int changes = 0;
+        int gestures = 0;
+    };
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    SlamityProcessor source;
+    setDistinctValues(source);
+
+    juce::MemoryBlock binaryState, xmlState;
+    source.getStateInformation(binaryState);
+    {
+        const auto xml = source.apvts.copyState().createXml();
+        juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+    }
+
+    {
+        SlamityProcessor restored;
+        restore(restored, binaryState, binaryState.getSize());
+        check(sameValues(source, restored), "binary state restores every parameter");
+    }
+    {
+        SlamityProcessor restored;
+        restore(restored, xmlState, xmlState.getSize());
+        check(sameValues(source, restored), "legacy XML state restores every parameter");
+    }
+    {
+        SlamityProcessor restored, defaults;
+        bool ok = true;
+        for (size_t size = 0; size < binaryState.getSize(); ++size)
+        {
+            restore(restored, binaryState, size);
+            ok &= sameValues(restored, defaults);
+        }
+        check(ok, "truncated binary state restores nothing");
+    }
+    {
+        SlamityProcessor restored, defaults;
+        juce::MemoryBlock wrongVersion(binaryState);
+        static_cast<juce::uint8*>(wrongVersion.getData())[4] = 0;
+        restore(restored, wrongVersion, wrongVersion.getSize());
+        check(sameValues(restored, defaults), "version 0 restores nothing");
+
+        juce::MemoryBlock wrongCount(binaryState);
+        static_cast<juce::uint8*>(wrongCount.getData())[6] += 1;
+        restore(restored, wrongCount, wrongCount.getSize());
+        check(sameValues(restored, defaults), "a count longer than the data restores nothing");
+    }
+
+    {
+        SlamityProcessor restored;
+        GestureCounter counter(restored);
+        restore(restored, binaryState, binaryState.getSize());
+        check(counter.changes > 0 && counter.gestures == 0, "a restore moves the parameters without gestures");
+    }
+    {
+        SlamityProcessor processor;
+        GestureCounter counter(processor);
+        processor.setCurrentProgram(processor.getNumPrograms() - 1);
+        check(counter.changes > 0 && counter.gestures == 0, "a program change moves the parameters without gestures");
+    }
+    {
+        SlamityProcessor processor;
+        processor.storeSnapshot(SlamityProcessor::Snapshot::a);
+        setDistinctValues(processor);
+        processor.storeSnapshot(SlamityProcessor::Snapshot::b);
+
+        GestureCounter counter(processor);
+        processor.recallSnapshot(SlamityProcessor::Snapshot::a);
+        check(counter.changes > 0 && counter.gestures == counter.changes, "an A/B recall moves each parameter in a gesture");
+    }
+
+    {
+        SlamityProcessor processor, defaults;
+        processor.apvts.getParameter("drumDrive")->setValueNotifyingHost(0.5f);
+        processor.setCurrentProgram(processor.getCurrentProgram());
+        check(sameValues(processor, defaults), "re-selecting the current program loads it again");
+    }
+    {
+        SlamityProcessor restored, defaults;
+        restore(restored, binaryState, binaryState.getSize());
+        restored.setCurrentProgram(restored.getCurrentProgram());
+        check(sameValues(source, restored), "a re-select straight after a restore keeps the restored state");
+
+        restored.setCurrentProgram(restored.getCurrentProgram());
+        bool presetLoaded = true;
+        for (int i = 0; i < SlamityDSP::numParameters; ++i)
+            presetLoaded &= restored.getParameters()[i]->getValue() == defaults.getParameters()[i]->getValue();
+        check(presetLoaded, "a later re-select loads the program");
+    }
+
+    std::printf("%s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
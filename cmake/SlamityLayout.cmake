@@ -0,0 +1,82 @@
+# Compiles GUI/layout.txt into a C++ header of constexpr layout values.
+#
+# Run as a script at build time:
+#   cmake -DLAYOUT_FILE=<layout.txt> -DOUTPUT_FILE=<header> -P SlamityLayout.cmake
+#
+# Each non-comment line is "name = number". Every name becomes an enumerator
+# of SlamityLayoutTable::Key, indexing the values and names arrays.
+
+cmake_minimum_required(VERSION 3.22)
+
+if (NOT LAYOUT_FILE OR NOT OUTPUT_FILE)
+    message(FATAL_ERROR "SlamityLayout.cmake needs LAYOUT_FILE and OUTPUT_FILE")
+endif()
+
+file(STRINGS "${LAYOUT_FILE}" lines ENCODING UTF-8)
+
+set(keys "")
+set(enumerators "")
+set(values "")
+set(names "")
+set(lineNumber 0)
+
+foreach (line IN LISTS lines)
+    math(EXPR lineNumber "${lineNumber} + 1")
+    string(STRIP "${line}" line)
+    if (line STREQUAL "" OR line MATCHES "^#")
+        continue()
+    endif()
+
+    if (NOT line MATCHES "^([A-Za-z_][A-Za-z0-9_]*)[ \t]*=[ \t]*([-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?)[ \t]*$")
+        message(FATAL_ERROR "${LAYOUT_FILE}:${lineNumber}: expected 'name = number', got '${line}'")
+    endif()
+
+    set(key "${CMAKE_MATCH_1}")
+    set(value "${CMAKE_MATCH_2}")
+    if (key IN_LIST keys)
+        message(FATAL_ERROR "${LAYOUT_FILE}:${lineNumber}: '${key}' is already defined")
+    endif()
+    list(APPEND keys "${key}")
+
+    # A float literal needs a decimal point or exponent before the suffix
+    if (NOT value MATCHES "[.eE]")
+        set(value "${value}.0")
+    endif()
+
+    string(APPEND enumerators "        ${key},\n")
+    string(APPEND values "        ${value}f,\n")
+    string(APPEND names "        \"${key}\",\n")
+endforeach()
+
+set(content "// Generated from ${LAYOUT_FILE} by cmake/SlamityLayout.cmake. Do not edit.
+#pragma once
+
+namespace SlamityLayoutTable
+{
+    enum Key
+    {
+${enumerators}        numKeys
+    };
+
+    inline constexpr float values[numKeys] =
+    {
+${values}    };
+
+    inline constexpr const char* names[numKeys] =
+    {
+${names}    };
+
+    inline constexpr const char* sourceFile = \"${LAYOUT_FILE}\";
+}
+")
+
+# Only touch the header when it changes, so editing a comment in layout.txt
+# doesn't rebuild the editor
+if (EXISTS "${OUTPUT_FILE}")
+    file(READ "${OUTPUT_FILE}" previous)
+    if (previous STREQUAL content)
+        return()
+    endif()
+endif()
+
+file(WRITE "${OUTPUT_FILE}" "${content}")